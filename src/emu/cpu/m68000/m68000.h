@@ -88,6 +88,7 @@ DECLARE_LEGACY_CPU_DEVICE(SCC68070, scc68070);
 
 
 void m68k_set_encrypted_opcode_range(running_device *device, offs_t start, offs_t end);
+void m68k_set_block_cache_enable(int enable);
 
 unsigned int m68k_disassemble_raw(char* str_buff, unsigned int pc, const unsigned char* opdata, const unsigned char* argdata, unsigned int cpu_type);
 
@@ -0,0 +1,231 @@
+/* ======================================================================== */
+/* ========================== BASIC BLOCK CACHE =========================== */
+/* ======================================================================== */
+
+/*
+    The block cache sits in front of the opcode fetch/dispatch of the 68000
+    and 68010.  Straight-line runs of instructions in ROM are decoded once
+    into blocks of { handler, base cycles, instruction words } so the main
+    loop no longer has to index the jump and cycle tables for every
+    instruction.  While an op runs, its words (opcode, extension words and
+    the following prefetch word) are published as the fetch window that
+    m68ki_read_imm_16/32 consult before going to the memory system.
+
+    Only code that lives in read-only banks is cached: the read side must be
+    a bank and the write side must not be, so the CPU cannot modify it.
+    Everything else (RAM, I/O, odd addresses) falls back to the normal
+    fetch.  Bank switches, decrypted region changes and map changes all bump
+    the map generation of the space's direct_read_data; the whole cache is
+    thrown away when it changes.
+
+    Cached ops are only used while the program counter follows them, so
+    branches, exceptions and interrupts simply leave the block and the next
+    one is looked up.
+*/
+
+#define M68K_BLOCK_HASH_BITS		12
+#define M68K_BLOCK_HASH_SIZE		(1 << M68K_BLOCK_HASH_BITS)
+#define M68K_BLOCK_MAX_OPS			32			/* instructions per block */
+#define M68K_BLOCK_MAX_BLOCKS		8192		/* blocks before the cache is flushed */
+#define M68K_BLOCK_MAX_CODE			(M68K_BLOCK_MAX_BLOCKS * 4)	/* ops before the cache is flushed */
+#define M68K_BLOCK_MAX_WORDS		6			/* longest 68000/68010 instruction is 5 words, plus prefetch */
+#define M68K_BLOCK_FETCH_BYTES		16			/* disassembler input buffer */
+
+#define M68K_BLOCK_HASH(pc)			((((pc) >> 1) ^ ((pc) >> (M68K_BLOCK_HASH_BITS + 1))) & (M68K_BLOCK_HASH_SIZE - 1))
+
+typedef struct _m68k_block_op m68k_block_op;
+struct _m68k_block_op
+{
+	void	(*handler)(m68ki_cpu_core *m68k);	/* opcode handler */
+	UINT32	pc;									/* address of the opcode */
+	UINT16	words[M68K_BLOCK_MAX_WORDS];		/* opcode, extension words, prefetch */
+	UINT8	length;								/* instruction length in bytes */
+	UINT8	cycles;								/* base cycle count */
+};
+
+typedef struct _m68k_block m68k_block;
+struct _m68k_block
+{
+	m68k_block *	next;						/* next block in the hash chain */
+	UINT32			pc;							/* address of the first opcode */
+	int				numops;						/* number of ops (0 = not cacheable) */
+	m68k_block_op *	ops;						/* pointer to the first op */
+};
+
+struct _m68k_block_cache
+{
+	direct_read_data *	direct;					/* direct access data of the program space */
+	UINT32				generation;				/* generation the cache contents were built from */
+	int					numblocks;				/* blocks in use */
+	int					numops;					/* ops in use */
+	m68k_block *		hash[M68K_BLOCK_HASH_SIZE];
+	m68k_block			blocks[M68K_BLOCK_MAX_BLOCKS];
+	m68k_block_op		ops[M68K_BLOCK_MAX_CODE];
+};
+
+/* global enable, changed by the front end */
+static int m68k_block_cache_enabled = TRUE;
+
+void m68k_set_block_cache_enable(int enable)
+{
+	m68k_block_cache_enabled = enable;
+}
+
+
+/* throw away all blocks */
+static void m68kblk_flush(m68k_block_cache *cache)
+{
+	memset(cache->hash, 0, sizeof(cache->hash));
+	cache->numblocks = 0;
+	cache->numops = 0;
+	cache->generation = cache->direct->map_generation();
+}
+
+
+/* allocate the cache for cores that can use it */
+static void m68kblk_init(m68ki_cpu_core *m68k)
+{
+	if (!CPU_TYPE_IS_010_LESS(m68k->cpu_type))
+		return;
+
+	m68k->blockcache = auto_alloc_clear(m68k->device->machine, m68k_block_cache);
+	m68k->blockcache->direct = &m68k->program->direct();
+	m68kblk_flush(m68k->blockcache);
+}
+
+
+/* read an opcode word the same way the interpreter does */
+INLINE UINT16 m68kblk_read_word(m68ki_cpu_core *m68k, offs_t address)
+{
+#if defined(ARM_ENABLED)
+	return (*m68k->memory.readimm16)(m68k->program, address);
+#else
+	return m68k->memory.readimm16(address);
+#endif
+}
+
+
+/* is the word at this address in memory the CPU cannot write? */
+INLINE int m68kblk_word_is_rom(address_space *space, offs_t address)
+{
+	return space->get_read_ptr(address) != NULL && space->get_write_ptr(address) == NULL &&
+		   space->get_read_ptr(address + 1) != NULL && space->get_write_ptr(address + 1) == NULL;
+}
+
+
+/* decode a new block starting at pc */
+static m68k_block *m68kblk_compile(m68ki_cpu_core *m68k, m68k_block_cache *cache, UINT32 pc)
+{
+	m68k_block *block;
+	int hash = M68K_BLOCK_HASH(pc);
+
+	/* make room */
+	if (cache->numblocks >= M68K_BLOCK_MAX_BLOCKS || cache->numops + M68K_BLOCK_MAX_OPS > M68K_BLOCK_MAX_CODE)
+		m68kblk_flush(cache);
+
+	g_profiler.start(PROFILER_DRC_COMPILE);
+
+	block = &cache->blocks[cache->numblocks++];
+	block->pc = pc;
+	block->numops = 0;
+	block->ops = &cache->ops[cache->numops];
+
+	if (!(pc & 1))
+	{
+		while (block->numops < M68K_BLOCK_MAX_OPS)
+		{
+			UINT8 opbuf[M68K_BLOCK_FETCH_BYTES];
+			char dasm[1024];
+			m68k_block_op *op;
+			UINT32 flags, length, word;
+			int bytes;
+
+			/* fetch as much of the instruction as lives in ROM */
+			memset(opbuf, 0, sizeof(opbuf));
+			for (bytes = 0; bytes < M68K_BLOCK_MAX_WORDS * 2; bytes += 2)
+			{
+				UINT16 data;
+				if (!m68kblk_word_is_rom(m68k->program, pc + bytes))
+					break;
+				data = m68kblk_read_word(m68k, pc + bytes);
+				opbuf[bytes] = data >> 8;
+				opbuf[bytes + 1] = data;
+			}
+
+			/* we need at least the opcode and its prefetch word */
+			if (bytes < 4)
+				break;
+
+			/* the whole instruction and the word after it must be cached */
+			flags = m68k_disassemble_raw(dasm, pc, opbuf, opbuf, m68k->dasm_type);
+			length = flags & DASMFLAG_LENGTHMASK;
+			if (length < 2 || length + 2 > bytes)
+				break;
+
+			op = &block->ops[block->numops++];
+			op->pc = pc;
+			for (word = 0; word <= length / 2; word++)
+				op->words[word] = (opbuf[word * 2] << 8) | opbuf[word * 2 + 1];
+			op->length = length;
+			op->handler = m68ki_instruction_jump_table[op->words[0]];
+			op->cycles = m68k->cyc_instruction[op->words[0]];
+			pc += length;
+
+			/* stop after calls, returns and unconditional jumps */
+			if (flags & (DASMFLAG_STEP_OVER | DASMFLAG_STEP_OUT))
+				break;
+			if ((op->words[0] & 0xff00) == 0x6000 || (op->words[0] & 0xffc0) == 0x4ec0)
+				break;
+		}
+	}
+
+	cache->numops += block->numops;
+	block->next = cache->hash[hash];
+	cache->hash[hash] = block;
+
+	g_profiler.stop();
+	return block;
+}
+
+
+/* find or build the block for an address */
+INLINE m68k_block *m68kblk_lookup(m68ki_cpu_core *m68k, m68k_block_cache *cache, UINT32 pc)
+{
+	m68k_block *block;
+
+	if (cache->generation != cache->direct->map_generation())
+		m68kblk_flush(cache);
+
+	for (block = cache->hash[M68K_BLOCK_HASH(pc)]; block != NULL; block = block->next)
+		if (block->pc == pc)
+			return block;
+
+	return m68kblk_compile(m68k, cache, pc);
+}
+
+
+/* run a block for as long as the program counter follows it */
+INLINE void m68kblk_execute(m68ki_cpu_core *m68k, m68k_block_cache *cache, const m68k_block *block)
+{
+	const m68k_block_op *op = block->ops;
+	const m68k_block_op *end = op + block->numops;
+	UINT32 generation = cache->generation;
+
+	do
+	{
+		REG_PPC = REG_PC;
+		m68k->ir = op->words[0];
+		REG_PC += 2;
+		m68k->pref_addr = REG_PC;
+		m68k->pref_data = op->words[1];
+		m68k->fetch_pc = op->pc;
+		m68k->fetch_bytes = op->length;
+		m68k->fetch_words = op->words;
+		(*op->handler)(m68k);
+		m68k->remaining_cycles -= op->cycles;
+	}
+	while (++op < end && REG_PC == op->pc && m68k->remaining_cycles > 0 && cache->direct->map_generation() == generation);
+
+	/* close the fetch window before returning to the interpreter */
+	m68k->fetch_bytes = 0;
+}
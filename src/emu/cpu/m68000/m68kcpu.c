@@ -39,6 +39,7 @@ static const char copyright_notice[] =
 #include "m68kfpu.c"
 
 #include "m68kmmu.h"
+#include "m68kblk.c"
 
 extern void m68040_fpu_op0(m68ki_cpu_core *m68k);
 extern void m68040_fpu_op1(m68ki_cpu_core *m68k);
@@ -552,6 +553,9 @@ static void m68k_postload(running_machine *machine, void *param)
 	m68k->stopped = m68k->save_stopped ? STOP_LEVEL_STOP : 0
 		        | m68k->save_halted  ? STOP_LEVEL_HALT : 0;
 	m68ki_jump(m68k, REG_PC);
+
+	if (m68k->blockcache != NULL)
+		m68kblk_flush(m68k->blockcache);
 }
 
 /* translate logical to physical addresses */
@@ -597,12 +601,26 @@ static CPU_EXECUTE( m68k )
 		/* Return point if we had an address error */
 		m68ki_set_address_error_trap(m68k); /* auto-disable (see m68kcpu.h) */
 
+		/* An address error may have left the block cache fetch window open */
+		m68k->fetch_bytes = 0;
+
 		/* Main loop.  Keep going until we run out of clock cycles */
 		do
 		{
 			/* Set tracing accodring to T1. (T0 is done inside instruction) */
 			m68ki_trace_t1(); /* auto-disable (see m68kcpu.h) */
 
+			/* Run cached code if we have it */
+			if (m68k->blockcache != NULL && m68k_block_cache_enabled)
+			{
+				const m68k_block *block = m68kblk_lookup(m68k, m68k->blockcache, REG_PC);
+				if (block->numops != 0)
+				{
+					m68kblk_execute(m68k, m68k->blockcache, block);
+					continue;
+				}
+			}
+
 			/* Record previous program counter */
 			REG_PPC = REG_PC;
 
@@ -631,6 +649,7 @@ static CPU_INIT( m68k )
 	m68k->device = device;
 	m68k->program = device->space(AS_PROGRAM);
 	m68k->int_ack_callback = irqcallback;
+	m68k->idle_detect = device->idle_detection();
 
 	/* The first call to this function initializes the opcode handler jump table */
 	if(!emulation_initialized)
@@ -669,6 +688,10 @@ static CPU_RESET( m68k )
 	/* Disable the PMMU on reset */
 	m68k->pmmu_enabled = 0;
 
+	/* Drivers may patch their ROMs before a reset */
+	if (m68k->blockcache != NULL)
+		m68kblk_flush(m68k->blockcache);
+
 	/* Clear all stop levels and eat up all remaining cycles */
 	m68k->stopped = 0;
 	if (m68k->remaining_cycles > 0)
@@ -1412,6 +1435,60 @@ void m68k_memory_interface::init32mmu(address_space &space)
 }
 #endif
 
+/****************************************************************************
+ * Direct page table
+ ****************************************************************************/
+
+/* resolve a stale page of the direct page table */
+void m68kmem_resolve_page(m68k_fastmem *fastmem, m68k_fastmem_page *page, offs_t address)
+{
+	offs_t bytestart = address & fastmem->bytemask & ~M68K_FASTMEM_PAGE_MASK;
+	offs_t byteend = bytestart + M68K_FASTMEM_PAGE_MASK;
+
+	page->read = fastmem->space->get_direct_page(ROW_READ, bytestart, byteend);
+	page->write = fastmem->space->get_direct_page(ROW_WRITE, bytestart, byteend);
+	page->generation = fastmem->direct->map_generation();
+}
+
+/* allocate the page table for cores with a 16-bit data bus and up to 24 address bits */
+static void m68kmem_init(m68ki_cpu_core *m68k)
+{
+	m68k_fastmem *fastmem;
+	int pages, pagenum;
+
+	if (m68k->program->data_width() != 16 || m68k->program->addr_width() > 24)
+		return;
+
+	pages = (m68k->program->bytemask() >> M68K_FASTMEM_PAGE_BITS) + 1;
+	fastmem = auto_alloc_clear(m68k->device->machine, m68k_fastmem);
+	fastmem->space = m68k->program;
+	fastmem->direct = &m68k->program->direct();
+	fastmem->bytemask = m68k->program->bytemask();
+	fastmem->page = auto_alloc_array_clear(m68k->device->machine, m68k_fastmem_page, pages);
+
+	/* every page starts out stale */
+	for (pagenum = 0; pagenum < pages; pagenum++)
+		fastmem->page[pagenum].generation = fastmem->direct->map_generation() - 1;
+	m68k->fastmem = fastmem;
+}
+
+
+/****************************************************************************
+ * Idle loop detection
+ ****************************************************************************/
+
+/* a short backward branch was taken; hand the registers to the detector */
+void m68ki_idle_branch(m68ki_cpu_core *m68k)
+{
+	UINT32 regs[18];
+
+	memcpy(regs, REG_DA, sizeof(REG_DA));
+	regs[16] = m68ki_get_sr(m68k);
+	regs[17] = m68k->int_level;
+	m68k->device->idle_loop_branch(REG_PC, m68k->writes, m68k->program->handler_reads(), regs, ARRAY_LENGTH(regs));
+}
+
+
 void m68k_set_reset_callback(running_device *device, m68k_reset_func callback)
 {
 	m68ki_cpu_core *m68k = get_safe_token(device);
@@ -1524,6 +1601,8 @@ static CPU_INIT( m68000 )
 	m68k->cyc_reset        = 132;
 	m68k->has_pmmu	       = 0;
 
+	m68kblk_init(m68k);
+	m68kmem_init(m68k);
 	define_state(device);
 }
 
@@ -1574,6 +1653,8 @@ static CPU_INIT( m68008 )
 	m68k->cyc_reset        = 132;
 	m68k->has_pmmu	       = 0;
 
+	m68kblk_init(m68k);
+	m68kmem_init(m68k);
 	define_state(device);
 }
 
@@ -1628,6 +1709,8 @@ static CPU_INIT( m68010 )
 	m68k->cyc_reset        = 130;
 	m68k->has_pmmu	       = 0;
 
+	m68kblk_init(m68k);
+	m68kmem_init(m68k);
 	define_state(device);
 }
 
@@ -26,6 +26,8 @@
 #define __M68KCPU_H__
 
 typedef struct _m68ki_cpu_core m68ki_cpu_core;
+typedef struct _m68k_block_cache m68k_block_cache;
+typedef struct _m68k_fastmem m68k_fastmem;
 
 
 #include "m68000.h"
@@ -688,6 +690,19 @@ struct _m68ki_cpu_core
 
 	UINT32		iotemp;
 
+	/* basic block cache (NULL if the core does not use it) */
+	m68k_block_cache *blockcache;
+	UINT32 fetch_pc;            /* address of the instruction being run from the cache */
+	UINT32 fetch_bytes;         /* its length, or 0 when not running from the cache */
+	const UINT16 *fetch_words;  /* its pre-decoded words, plus the word following it */
+
+	/* direct page table for plain RAM/ROM (NULL if the core does not use it) */
+	m68k_fastmem *fastmem;
+
+	/* idle loop detection */
+	int idle_detect;            /* report short backward branches to the detector */
+	UINT32 writes;              /* memory writes, so the detector can tell a loop wrote nothing */
+
 	/* save state data */
 	UINT16 save_sr;
 	UINT8 save_stopped;
@@ -825,6 +840,136 @@ INLINE void m68ki_check_interrupts(m68ki_cpu_core *m68k);            /* ASG: che
 char* m68ki_disassemble_quick(unsigned int pc, unsigned int cpu_type);
 
 
+/* ======================================================================== */
+/* ========================== DIRECT PAGE ACCESS ========================== */
+/* ======================================================================== */
+
+/* Data accesses and opcode fetches of the 68000/68010 skip the memory system
+ * delegates when they hit a page that is plain RAM or ROM.  Each page of the
+ * program space is resolved on first use into read and write base pointers
+ * (NULL when the page needs its handlers) and tagged with the map generation of
+ * the space's direct_read_data.  populate_range and bank switches bump that
+ * generation, so stale pages are simply resolved again on their next access.
+ */
+#define M68K_FASTMEM_PAGE_BITS		12
+#define M68K_FASTMEM_PAGE_MASK		((1 << M68K_FASTMEM_PAGE_BITS) - 1)
+
+typedef struct _m68k_fastmem_page m68k_fastmem_page;
+struct _m68k_fastmem_page
+{
+	UINT8 *		read;			/* base of the page for reads, or NULL */
+	UINT8 *		write;			/* base of the page for writes, or NULL */
+	UINT32		generation;		/* map generation the pointers belong to */
+};
+
+struct _m68k_fastmem
+{
+	address_space *			space;		/* program space */
+	direct_read_data *		direct;		/* its direct access data */
+	offs_t					bytemask;	/* byte address mask of the space */
+	m68k_fastmem_page *		page;		/* one entry per page */
+};
+
+void m68kmem_resolve_page(m68k_fastmem *fastmem, m68k_fastmem_page *page, offs_t address);
+void m68ki_idle_branch(m68ki_cpu_core *m68k);
+
+INLINE m68k_fastmem_page *m68ki_fastmem_page(m68k_fastmem *fastmem, UINT32 address)
+{
+	m68k_fastmem_page *page = &fastmem->page[(address & fastmem->bytemask) >> M68K_FASTMEM_PAGE_BITS];
+	if (UNEXPECTED(page->generation != fastmem->direct->map_generation()))
+		m68kmem_resolve_page(fastmem, page, address);
+	return page;
+}
+
+/* Pointer to size bytes at address if they are plain memory in one page, else NULL.
+ * Byte addresses must already be adjusted with BYTE_XOR_BE.
+ */
+INLINE UINT8 *m68ki_fastmem_read_ptr(m68ki_cpu_core *m68k, UINT32 address, UINT32 size)
+{
+	UINT8 *base;
+
+	if (m68k->fastmem == NULL || (address & M68K_FASTMEM_PAGE_MASK) + size - 1 > M68K_FASTMEM_PAGE_MASK)
+		return NULL;
+	base = m68ki_fastmem_page(m68k->fastmem, address)->read;
+	return (base != NULL) ? base + (address & M68K_FASTMEM_PAGE_MASK) : NULL;
+}
+
+INLINE UINT8 *m68ki_fastmem_write_ptr(m68ki_cpu_core *m68k, UINT32 address, UINT32 size)
+{
+	UINT8 *base;
+
+	if (m68k->fastmem == NULL || (address & M68K_FASTMEM_PAGE_MASK) + size - 1 > M68K_FASTMEM_PAGE_MASK)
+		return NULL;
+	base = m68ki_fastmem_page(m68k->fastmem, address)->write;
+	return (base != NULL) ? base + (address & M68K_FASTMEM_PAGE_MASK) : NULL;
+}
+
+/* 16-bit bus accesses; the memory system stores big-endian words in host order */
+INLINE int m68ki_fast_read_8(m68ki_cpu_core *m68k, UINT32 address, UINT32 *result)
+{
+	UINT8 *ptr = m68ki_fastmem_read_ptr(m68k, BYTE_XOR_BE(address), 1);
+	if (ptr == NULL)
+		return FALSE;
+	*result = *ptr;
+	return TRUE;
+}
+
+INLINE int m68ki_fast_read_16(m68ki_cpu_core *m68k, UINT32 address, UINT32 *result)
+{
+	UINT8 *ptr = m68ki_fastmem_read_ptr(m68k, address & ~1, 2);
+	if (ptr == NULL)
+		return FALSE;
+	*result = *(UINT16 *)ptr;
+	return TRUE;
+}
+
+INLINE int m68ki_fast_read_32(m68ki_cpu_core *m68k, UINT32 address, UINT32 *result)
+{
+	UINT8 *ptr = m68ki_fastmem_read_ptr(m68k, address & ~1, 4);
+	if (ptr == NULL)
+		return FALSE;
+	*result = (((UINT16 *)ptr)[0] << 16) | ((UINT16 *)ptr)[1];
+	return TRUE;
+}
+
+INLINE int m68ki_fast_write_8(m68ki_cpu_core *m68k, UINT32 address, UINT32 value)
+{
+	UINT8 *ptr;
+
+	m68k->writes++;
+	ptr = m68ki_fastmem_write_ptr(m68k, BYTE_XOR_BE(address), 1);
+	if (ptr == NULL)
+		return FALSE;
+	*ptr = value;
+	return TRUE;
+}
+
+INLINE int m68ki_fast_write_16(m68ki_cpu_core *m68k, UINT32 address, UINT32 value)
+{
+	UINT8 *ptr;
+
+	m68k->writes++;
+	ptr = m68ki_fastmem_write_ptr(m68k, address & ~1, 2);
+	if (ptr == NULL)
+		return FALSE;
+	*(UINT16 *)ptr = value;
+	return TRUE;
+}
+
+INLINE int m68ki_fast_write_32(m68ki_cpu_core *m68k, UINT32 address, UINT32 value)
+{
+	UINT8 *ptr;
+
+	m68k->writes++;
+	ptr = m68ki_fastmem_write_ptr(m68k, address & ~1, 4);
+	if (ptr == NULL)
+		return FALSE;
+	((UINT16 *)ptr)[0] = value >> 16;
+	((UINT16 *)ptr)[1] = value;
+	return TRUE;
+}
+
+
 /* ======================================================================== */
 /* =========================== UTILITY FUNCTIONS ========================== */
 /* ======================================================================== */
@@ -837,25 +982,37 @@ INLINE unsigned int m68k_read_immediate_32(m68ki_cpu_core *m68k, unsigned int ad
 
 INLINE unsigned int m68k_read_pcrelative_8(m68ki_cpu_core *m68k, unsigned int address)
 {
+	UINT32 result;
+
 	if (address >= m68k->encrypted_start && address < m68k->encrypted_end)
 		return (((*m68k->memory.readimm16)(m68k->program, address&~1)>>(8*(1-(address & 1))))&0xff);
 
+	if (m68ki_fast_read_8(m68k, address, &result))
+		return result;
 	return (*m68k->memory.read8)(m68k->program, address);
 }
 
 INLINE unsigned int m68k_read_pcrelative_16(m68ki_cpu_core *m68k, unsigned int address)
 {
+	UINT32 result;
+
 	if (address >= m68k->encrypted_start && address < m68k->encrypted_end)
 		return (*m68k->memory.readimm16)(m68k->program, address);
 
+	if (m68ki_fast_read_16(m68k, address, &result))
+		return result;
 	return (*m68k->memory.read16)(m68k->program, address);
 }
 
 INLINE unsigned int m68k_read_pcrelative_32(m68ki_cpu_core *m68k, unsigned int address)
 {
+	UINT32 result;
+
 	if (address >= m68k->encrypted_start && address < m68k->encrypted_end)
 		return m68k_read_immediate_32(m68k, address);
 
+	if (m68ki_fast_read_32(m68k, address, &result))
+		return result;
 	return (*m68k->memory.read32)(m68k->program, address);
 }
 
@@ -867,6 +1024,8 @@ INLINE unsigned int m68k_read_pcrelative_32(m68ki_cpu_core *m68k, unsigned int a
  */
 INLINE void m68kx_write_memory_32_pd(m68ki_cpu_core *m68k, unsigned int address, unsigned int value)
 {
+	if (m68ki_fast_write_32(m68k, address, value))
+		return;
 	(m68k->memory.write16)(m68k->program, address+2, value>>16);
 	(m68k->memory.write16)(m68k->program, address, value&0xffff);
 }
@@ -874,6 +1033,14 @@ INLINE void m68kx_write_memory_32_pd(m68ki_cpu_core *m68k, unsigned int address,
 
 /* ---------------------------- Read Immediate ---------------------------- */
 
+/* Opcode fetches go straight to the direct access data when the core has a page table */
+INLINE UINT32 m68ki_fetch_imm_16(m68ki_cpu_core *m68k, UINT32 address)
+{
+	if (m68k->fastmem != NULL)
+		return m68k->fastmem->direct->read_decrypted_word(address);
+	return (*m68k->memory.readimm16)(m68k->program, address);
+}
+
 /* Handles all immediate reads, does address error check, function code setting,
  * and prefetching if they are enabled in m68kconf.h
  */
@@ -883,15 +1050,25 @@ INLINE UINT32 m68ki_read_imm_16(m68ki_cpu_core *m68k)
 
 	m68ki_check_address_error(m68k, REG_PC, MODE_READ, m68k->s_flag | FUNCTION_CODE_USER_PROGRAM); /* auto-disable (see m68kcpu.h) */
 
+	/* extension words pre-decoded by the block cache */
+	if ((UINT32)(REG_PC - m68k->fetch_pc) < m68k->fetch_bytes)
+	{
+		const UINT16 *words = m68k->fetch_words + ((REG_PC - m68k->fetch_pc) >> 1);
+		REG_PC += 2;
+		m68k->pref_addr = REG_PC;
+		m68k->pref_data = words[1];
+		return words[0];
+	}
+
 	if(REG_PC != m68k->pref_addr)
 	{
 		m68k->pref_addr = REG_PC;
-		m68k->pref_data = (*m68k->memory.readimm16)(m68k->program, m68k->pref_addr);
+		m68k->pref_data = m68ki_fetch_imm_16(m68k, m68k->pref_addr);
 	}
 	result = MASK_OUT_ABOVE_16(m68k->pref_data);
 	REG_PC += 2;
 	m68k->pref_addr = REG_PC;
-	m68k->pref_data = (*m68k->memory.readimm16)(m68k->program, m68k->pref_addr);
+	m68k->pref_data = m68ki_fetch_imm_16(m68k, m68k->pref_addr);
 	return result;
 }
 
@@ -901,20 +1078,30 @@ INLINE UINT32 m68ki_read_imm_32(m68ki_cpu_core *m68k)
 
 	m68ki_check_address_error(m68k, REG_PC, MODE_READ, m68k->s_flag | FUNCTION_CODE_USER_PROGRAM); /* auto-disable (see m68kcpu.h) */
 
+	/* extension words pre-decoded by the block cache */
+	if ((UINT32)(REG_PC - m68k->fetch_pc) < m68k->fetch_bytes && (UINT32)(REG_PC - m68k->fetch_pc) + 2 < m68k->fetch_bytes)
+	{
+		const UINT16 *words = m68k->fetch_words + ((REG_PC - m68k->fetch_pc) >> 1);
+		REG_PC += 4;
+		m68k->pref_addr = REG_PC;
+		m68k->pref_data = words[2];
+		return (words[0] << 16) | words[1];
+	}
+
 	if(REG_PC != m68k->pref_addr)
 	{
 		m68k->pref_addr = REG_PC;
-		m68k->pref_data = (*m68k->memory.readimm16)(m68k->program, m68k->pref_addr);
+		m68k->pref_data = m68ki_fetch_imm_16(m68k, m68k->pref_addr);
 	}
 	temp_val = MASK_OUT_ABOVE_16(m68k->pref_data);
 	REG_PC += 2;
 	m68k->pref_addr = REG_PC;
-	m68k->pref_data = (*m68k->memory.readimm16)(m68k->program, m68k->pref_addr);
+	m68k->pref_data = m68ki_fetch_imm_16(m68k, m68k->pref_addr);
 
 	temp_val = MASK_OUT_ABOVE_32((temp_val << 16) | MASK_OUT_ABOVE_16(m68k->pref_data));
 	REG_PC += 2;
 	m68k->pref_addr = REG_PC;
-	m68k->pref_data = (*m68k->memory.readimm16)(m68k->program, m68k->pref_addr);
+	m68k->pref_data = m68ki_fetch_imm_16(m68k, m68k->pref_addr);
 
 	return temp_val;
 }
@@ -931,27 +1118,41 @@ INLINE UINT32 m68ki_read_imm_32(m68ki_cpu_core *m68k)
  */
 INLINE UINT32 m68ki_read_8_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc)
 {
+	UINT32 result;
+
+	if (m68ki_fast_read_8(m68k, address, &result))
+		return result;
 	return (*m68k->memory.read8)(m68k->program, address);
 }
 INLINE UINT32 m68ki_read_16_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc)
 {
+	UINT32 result;
+
 	if (CPU_TYPE_IS_010_LESS(m68k->cpu_type))
 	{
 		m68ki_check_address_error(m68k, address, MODE_READ, fc);
 	}
+	if (m68ki_fast_read_16(m68k, address, &result))
+		return result;
 	return (*m68k->memory.read16)(m68k->program, address);
 }
 INLINE UINT32 m68ki_read_32_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc)
 {
+	UINT32 result;
+
 	if (CPU_TYPE_IS_010_LESS(m68k->cpu_type))
 	{
 		m68ki_check_address_error(m68k, address, MODE_READ, fc);
 	}
+	if (m68ki_fast_read_32(m68k, address, &result))
+		return result;
 	return (*m68k->memory.read32)(m68k->program, address);
 }
 
 INLINE void m68ki_write_8_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc, UINT32 value)
 {
+	if (m68ki_fast_write_8(m68k, address, value))
+		return;
 	(*m68k->memory.write8)(m68k->program, address, value);
 }
 INLINE void m68ki_write_16_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc, UINT32 value)
@@ -960,6 +1161,8 @@ INLINE void m68ki_write_16_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc, U
 	{
 		m68ki_check_address_error(m68k, address, MODE_WRITE, fc);
 	}
+	if (m68ki_fast_write_16(m68k, address, value))
+		return;
 	(*m68k->memory.write16)(m68k->program, address, value);
 }
 INLINE void m68ki_write_32_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc, UINT32 value)
@@ -968,6 +1171,8 @@ INLINE void m68ki_write_32_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc, U
 	{
 		m68ki_check_address_error(m68k, address, MODE_WRITE, fc);
 	}
+	if (m68ki_fast_write_32(m68k, address, value))
+		return;
 	(*m68k->memory.write32)(m68k->program, address, value);
 }
 
@@ -982,6 +1187,8 @@ INLINE void m68ki_write_32_pd_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc
 	{
 		m68ki_check_address_error(m68k, address, MODE_WRITE, fc);
 	}
+	if (m68ki_fast_write_32(m68k, address, value))
+		return;
 	(*m68k->memory.write16)(m68k->program, address+2, value>>16);
 	(*m68k->memory.write16)(m68k->program, address, value&0xffff);
 }
@@ -993,25 +1200,37 @@ INLINE unsigned int m68k_read_immediate_32(m68ki_cpu_core *m68k, unsigned int ad
 
 INLINE unsigned int m68k_read_pcrelative_8(m68ki_cpu_core *m68k, unsigned int address)
 {
+	UINT32 result;
+
 	if (address >= m68k->encrypted_start && address < m68k->encrypted_end)
 		return ((m68k->memory.readimm16(address&~1)>>(8*(1-(address & 1))))&0xff);
 
+	if (m68ki_fast_read_8(m68k, address, &result))
+		return result;
 	return m68k->memory.read8(address);
 }
 
 INLINE unsigned int m68k_read_pcrelative_16(m68ki_cpu_core *m68k, unsigned int address)
 {
+	UINT32 result;
+
 	if (address >= m68k->encrypted_start && address < m68k->encrypted_end)
 		return m68k->memory.readimm16(address);
 
+	if (m68ki_fast_read_16(m68k, address, &result))
+		return result;
 	return m68k->memory.read16(address);
 }
 
 INLINE unsigned int m68k_read_pcrelative_32(m68ki_cpu_core *m68k, unsigned int address)
 {
+	UINT32 result;
+
 	if (address >= m68k->encrypted_start && address < m68k->encrypted_end)
 		return m68k_read_immediate_32(m68k, address);
 
+	if (m68ki_fast_read_32(m68k, address, &result))
+		return result;
 	return m68k->memory.read32(address);
 }
 
@@ -1023,6 +1242,8 @@ INLINE unsigned int m68k_read_pcrelative_32(m68ki_cpu_core *m68k, unsigned int a
  */
 INLINE void m68kx_write_memory_32_pd(m68ki_cpu_core *m68k, unsigned int address, unsigned int value)
 {
+	if (m68ki_fast_write_32(m68k, address, value))
+		return;
 	m68k->memory.write16(address + 2, value >> 16);
 	m68k->memory.write16(address, value & 0xffff);
 }
@@ -1030,6 +1251,14 @@ INLINE void m68kx_write_memory_32_pd(m68ki_cpu_core *m68k, unsigned int address,
 
 /* ---------------------------- Read Immediate ---------------------------- */
 
+/* Opcode fetches go straight to the direct access data when the core has a page table */
+INLINE UINT32 m68ki_fetch_imm_16(m68ki_cpu_core *m68k, UINT32 address)
+{
+	if (m68k->fastmem != NULL)
+		return m68k->fastmem->direct->read_decrypted_word(address);
+	return m68k->memory.readimm16(address);
+}
+
 /* Handles all immediate reads, does address error check, function code setting,
  * and prefetching if they are enabled in m68kconf.h
  */
@@ -1039,15 +1268,25 @@ INLINE UINT32 m68ki_read_imm_16(m68ki_cpu_core *m68k)
 
 	m68ki_check_address_error(m68k, REG_PC, MODE_READ, m68k->s_flag | FUNCTION_CODE_USER_PROGRAM); /* auto-disable (see m68kcpu.h) */
 
+	/* extension words pre-decoded by the block cache */
+	if ((UINT32)(REG_PC - m68k->fetch_pc) < m68k->fetch_bytes)
+	{
+		const UINT16 *words = m68k->fetch_words + ((REG_PC - m68k->fetch_pc) >> 1);
+		REG_PC += 2;
+		m68k->pref_addr = REG_PC;
+		m68k->pref_data = words[1];
+		return words[0];
+	}
+
 	if(REG_PC != m68k->pref_addr)
 	{
 		m68k->pref_addr = REG_PC;
-		m68k->pref_data = m68k->memory.readimm16(m68k->pref_addr);
+		m68k->pref_data = m68ki_fetch_imm_16(m68k, m68k->pref_addr);
 	}
 	result = MASK_OUT_ABOVE_16(m68k->pref_data);
 	REG_PC += 2;
 	m68k->pref_addr = REG_PC;
-	m68k->pref_data = m68k->memory.readimm16(m68k->pref_addr);
+	m68k->pref_data = m68ki_fetch_imm_16(m68k, m68k->pref_addr);
 	return result;
 }
 
@@ -1057,20 +1296,30 @@ INLINE UINT32 m68ki_read_imm_32(m68ki_cpu_core *m68k)
 
 	m68ki_check_address_error(m68k, REG_PC, MODE_READ, m68k->s_flag | FUNCTION_CODE_USER_PROGRAM); /* auto-disable (see m68kcpu.h) */
 
+	/* extension words pre-decoded by the block cache */
+	if ((UINT32)(REG_PC - m68k->fetch_pc) < m68k->fetch_bytes && (UINT32)(REG_PC - m68k->fetch_pc) + 2 < m68k->fetch_bytes)
+	{
+		const UINT16 *words = m68k->fetch_words + ((REG_PC - m68k->fetch_pc) >> 1);
+		REG_PC += 4;
+		m68k->pref_addr = REG_PC;
+		m68k->pref_data = words[2];
+		return (words[0] << 16) | words[1];
+	}
+
 	if(REG_PC != m68k->pref_addr)
 	{
 		m68k->pref_addr = REG_PC;
-		m68k->pref_data = m68k->memory.readimm16(m68k->pref_addr);
+		m68k->pref_data = m68ki_fetch_imm_16(m68k, m68k->pref_addr);
 	}
 	temp_val = MASK_OUT_ABOVE_16(m68k->pref_data);
 	REG_PC += 2;
 	m68k->pref_addr = REG_PC;
-	m68k->pref_data = m68k->memory.readimm16(m68k->pref_addr);
+	m68k->pref_data = m68ki_fetch_imm_16(m68k, m68k->pref_addr);
 
 	temp_val = MASK_OUT_ABOVE_32((temp_val << 16) | MASK_OUT_ABOVE_16(m68k->pref_data));
 	REG_PC += 2;
 	m68k->pref_addr = REG_PC;
-	m68k->pref_data = m68k->memory.readimm16(m68k->pref_addr);
+	m68k->pref_data = m68ki_fetch_imm_16(m68k, m68k->pref_addr);
 
 	return temp_val;
 }
@@ -1087,27 +1336,41 @@ INLINE UINT32 m68ki_read_imm_32(m68ki_cpu_core *m68k)
  */
 INLINE UINT32 m68ki_read_8_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc)
 {
+	UINT32 result;
+
+	if (m68ki_fast_read_8(m68k, address, &result))
+		return result;
 	return m68k->memory.read8(address);
 }
 INLINE UINT32 m68ki_read_16_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc)
 {
+	UINT32 result;
+
 	if (CPU_TYPE_IS_010_LESS(m68k->cpu_type))
 	{
 		m68ki_check_address_error(m68k, address, MODE_READ, fc);
 	}
+	if (m68ki_fast_read_16(m68k, address, &result))
+		return result;
 	return m68k->memory.read16(address);
 }
 INLINE UINT32 m68ki_read_32_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc)
 {
+	UINT32 result;
+
 	if (CPU_TYPE_IS_010_LESS(m68k->cpu_type))
 	{
 		m68ki_check_address_error(m68k, address, MODE_READ, fc);
 	}
+	if (m68ki_fast_read_32(m68k, address, &result))
+		return result;
 	return m68k->memory.read32(address);
 }
 
 INLINE void m68ki_write_8_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc, UINT32 value)
 {
+	if (m68ki_fast_write_8(m68k, address, value))
+		return;
 	m68k->memory.write8(address, value);
 }
 INLINE void m68ki_write_16_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc, UINT32 value)
@@ -1116,6 +1379,8 @@ INLINE void m68ki_write_16_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc, U
 	{
 		m68ki_check_address_error(m68k, address, MODE_WRITE, fc);
 	}
+	if (m68ki_fast_write_16(m68k, address, value))
+		return;
 	m68k->memory.write16(address, value);
 }
 INLINE void m68ki_write_32_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc, UINT32 value)
@@ -1124,6 +1389,8 @@ INLINE void m68ki_write_32_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc, U
 	{
 		m68ki_check_address_error(m68k, address, MODE_WRITE, fc);
 	}
+	if (m68ki_fast_write_32(m68k, address, value))
+		return;
 	m68k->memory.write32(address, value);
 }
 
@@ -1138,6 +1405,8 @@ INLINE void m68ki_write_32_pd_fc(m68ki_cpu_core *m68k, UINT32 address, UINT32 fc
 	{
 		m68ki_check_address_error(m68k, address, MODE_WRITE, fc);
 	}
+	if (m68ki_fast_write_32(m68k, address, value))
+		return;
 	m68k->memory.write16(address + 2, value >> 16);
 	m68k->memory.write16(address, value & 0xffff);
 }
@@ -1403,16 +1672,22 @@ INLINE void m68ki_jump_vector(m68ki_cpu_core *m68k, UINT32 vector)
 INLINE void m68ki_branch_8(m68ki_cpu_core *m68k, UINT32 offset)
 {
 	REG_PC += MAKE_INT_8(offset);
+	if (UNEXPECTED(m68k->idle_detect) && MAKE_INT_8(offset) < 0 && MAKE_INT_8(offset) >= -IDLE_LOOP_MAX_BYTES)
+		m68ki_idle_branch(m68k);
 }
 
 INLINE void m68ki_branch_16(m68ki_cpu_core *m68k, UINT32 offset)
 {
 	REG_PC += MAKE_INT_16(offset);
+	if (UNEXPECTED(m68k->idle_detect) && MAKE_INT_16(offset) < 0 && MAKE_INT_16(offset) >= -IDLE_LOOP_MAX_BYTES)
+		m68ki_idle_branch(m68k);
 }
 
 INLINE void m68ki_branch_32(m68ki_cpu_core *m68k, UINT32 offset)
 {
 	REG_PC += offset;
+	if (UNEXPECTED(m68k->idle_detect) && MAKE_INT_32(offset) < 0 && MAKE_INT_32(offset) >= -IDLE_LOOP_MAX_BYTES)
+		m68ki_idle_branch(m68k);
 }
 
 
@@ -161,6 +161,9 @@ struct _z80_state
 	const UINT8 *	cc_xy;
 	const UINT8 *	cc_xycb;
 	const UINT8 *	cc_ex;
+	UINT8			idle_detect;		/* report short backward branches to the idle loop detector */
+	UINT8			idle_r;				/* refresh register when the last one was taken */
+	UINT32			writes;				/* memory and I/O writes, for the idle loop detector */
 };
 
 INLINE z80_state *get_safe_token(running_device *device)
@@ -473,6 +476,26 @@ INLINE void BURNODD(z80_state *z80, int cycles, int opcodes, int cyclesum)
 	}
 }
 
+/****************************************************************************/
+/* A short backward branch was taken; hand the registers to the idle loop   */
+/* detector and account for the refresh cycles of any iterations it skipped */
+/****************************************************************************/
+static void idle_branch(z80_state *z80)
+{
+	UINT32 regs[14];
+	int iterations;
+
+	regs[0] = z80->AF;	regs[1] = z80->BC;	regs[2] = z80->DE;	regs[3] = z80->HL;
+	regs[4] = z80->IX;	regs[5] = z80->IY;	regs[6] = z80->SP;	regs[7] = z80->WZ;
+	regs[8] = z80->af2.w.l;	regs[9] = z80->bc2.w.l;	regs[10] = z80->de2.w.l;	regs[11] = z80->hl2.w.l;
+	regs[12] = z80->iff1 | (z80->iff2 << 8) | (z80->im << 16) | (z80->i << 24);
+	regs[13] = z80->irq_state | (z80->nmi_pending << 8);
+
+	iterations = z80->device->idle_loop_branch(z80->PCD, z80->writes, z80->program->handler_reads() + z80->io->handler_reads(), regs, ARRAY_LENGTH(regs));
+	z80->r += iterations * (UINT8)(z80->r - z80->idle_r);
+	z80->idle_r = z80->r;
+}
+
 /***************************************************************
  * define an opcode function
  ***************************************************************/
@@ -600,7 +623,7 @@ INLINE void BURNODD(z80_state *z80, int cycles, int opcodes, int cyclesum)
 /***************************************************************
  * Output a byte to given I/O port
  ***************************************************************/
-#define OUT(Z,port,value)	(Z)->io->write_byte(port, value)
+#define OUT(Z,port,value)	do { (Z)->writes++; (Z)->io->write_byte(port, value); } while (0)
 
 /***************************************************************
  * Read a byte from given memory location
@@ -619,7 +642,7 @@ INLINE void RM16(z80_state *z80, UINT32 addr, PAIR *r)
 /***************************************************************
  * Write a byte to given memory location
  ***************************************************************/
-#define WM(Z,addr,value)	(Z)->program->write_byte(addr, value)
+#define WM(Z,addr,value)	do { (Z)->writes++; (Z)->program->write_byte(addr, value); } while (0)
 
 /***************************************************************
  * Write a word to given memory location
@@ -679,12 +702,23 @@ INLINE UINT32 ARG16(z80_state *z80)
  ***************************************************************/
 #define PUSH(Z,SR)	do { (Z)->SP -= 2; WM16((Z), (Z)->SPD, &(Z)->SR); } while (0)
 
+/***************************************************************
+ * Report a taken branch back to at most IDLE_LOOP_MAX_BYTES
+ * before the end of the branch instruction
+ ***************************************************************/
+#define IDLE_CHECK(Z, from) do {								\
+	if (UNEXPECTED((Z)->idle_detect) && (UINT16)((from) - (Z)->PC - 1) < IDLE_LOOP_MAX_BYTES) \
+		idle_branch(Z);											\
+} while (0)
+
 /***************************************************************
  * JP
  ***************************************************************/
 #define JP(Z) do {												\
+	UINT16 from = (Z)->PC + 2;									\
 	(Z)->PCD = ARG16(Z);										\
 	(Z)->WZ = (Z)->PCD;											\
+	IDLE_CHECK(Z, from);										\
 } while (0)
 
 /***************************************************************
@@ -693,8 +727,10 @@ INLINE UINT32 ARG16(z80_state *z80)
 #define JP_COND(Z, cond) do {									\
 	if (cond)													\
 	{															\
+		UINT16 from = (Z)->PC + 2;								\
 		(Z)->PCD = ARG16(Z);									\
 		(Z)->WZ = (Z)->PCD;										\
+		IDLE_CHECK(Z, from);									\
 	}															\
 	else														\
 	{															\
@@ -709,6 +745,7 @@ INLINE UINT32 ARG16(z80_state *z80)
 	INT8 arg = (INT8)ARG(Z);	/* ARG() also increments PC */	\
 	(Z)->PC += arg;				/* so don't do PC += ARG() */	\
 	(Z)->WZ = (Z)->PC;											\
+	IDLE_CHECK(Z, (Z)->PC - arg);								\
 } while (0)
 
 /***************************************************************
@@ -3474,6 +3511,7 @@ static CPU_INIT( z80 )
 	z80->program = device->space(AS_PROGRAM);
 	z80->direct = &z80->program->direct();
 	z80->io = device->space(AS_IO);
+	z80->idle_detect = device->idle_detection();
 	z80->IX = z80->IY = 0xffff; /* IX and IY are FFFF after a reset! */
 	z80->F = ZF;			/* Zero flag is set */
 
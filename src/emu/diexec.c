@@ -38,6 +38,7 @@
 ***************************************************************************/
 
 #include "emu.h"
+#include "emuopts.h"
 #include "profiler.h"
 #include "debugger.h"
 
@@ -61,6 +62,12 @@
 const int TRIGGER_INT			= -2000;
 const int TRIGGER_SUSPENDTIME	= -4000;
 
+// identical iterations before an idle loop is skipped; loops that poll a
+// handler never get this far, so two passes are proof enough
+const int IDLE_LOOP_CONFIRM		= 2;
+
+const offs_t IDLE_NO_TARGET		= ~0;
+
 
 
 //**************************************************************************
@@ -293,9 +300,19 @@ device_execute_interface::device_execute_interface(running_machine &machine, con
 	  m_divisor(0),
 	  m_divshift(0),
 	  m_cycles_per_second(0),
-	  m_attoseconds_per_cycle(0)
+	  m_attoseconds_per_cycle(0),
+	  m_idle_detect(false),
+	  m_idle_target(IDLE_NO_TARGET),
+	  m_idle_writes(0),
+	  m_idle_reads(0),
+	  m_idle_icount(0),
+	  m_idle_period(0),
+	  m_idle_repeats(0),
+	  m_idle_hits(0),
+	  m_idle_cycles(0)
 {
 	memset(&m_localtime, 0, sizeof(m_localtime));
+	memset(m_idle_regs, 0, sizeof(m_idle_regs));
 }
 
 
@@ -387,6 +404,62 @@ void device_execute_interface::abort_timeslice()
 }
 
 
+//-------------------------------------------------
+//  idle_loop_branch - called by cores with idle
+//  detection enabled each time they take a short
+//  backward branch; once the loop has come back
+//  to the same registers without writing anything
+//  or reading through a handler, only an
+//  interrupt or another device can end it, so
+//  whole iterations are skipped up to the end of
+//  the timeslice. Handler reads such as a beam
+//  position or a sound chip busy flag can change
+//  on their own, so those loops always run.
+//  Returns the number of iterations skipped
+//-------------------------------------------------
+
+int device_execute_interface::idle_loop_branch(offs_t target, UINT32 writes, UINT32 reads, const UINT32 *regs, int count)
+{
+	int icount = *m_icountptr;
+	int period = m_idle_icount - icount;
+
+	assert(count <= IDLE_LOOP_MAX_REGS);
+
+	// another loop, a write, a handler read or a new timeslice starts over
+	m_idle_icount = icount;
+	if (target != m_idle_target || writes != m_idle_writes || reads != m_idle_reads || period <= 0)
+	{
+		m_idle_target = target;
+		m_idle_writes = writes;
+		m_idle_reads = reads;
+		m_idle_repeats = 0;
+		return 0;
+	}
+
+	// so does anything that changed the registers or the path through the loop
+	if (m_idle_repeats == 0 || period != m_idle_period || memcmp(regs, m_idle_regs, count * sizeof(regs[0])) != 0)
+	{
+		memcpy(m_idle_regs, regs, count * sizeof(regs[0]));
+		m_idle_period = period;
+		m_idle_repeats = 1;
+		return 0;
+	}
+	if (++m_idle_repeats < IDLE_LOOP_CONFIRM)
+		return 0;
+
+	// leave the last partial iteration to the core so it ends the timeslice where it would have
+	int iterations = (icount - 1) / period;
+	if (iterations <= 0)
+		return 0;
+
+	*m_icountptr -= iterations * period;
+	m_idle_icount = *m_icountptr;
+	m_idle_hits++;
+	m_idle_cycles += (UINT64)iterations * period;
+	return iterations;
+}
+
+
 //-------------------------------------------------
 //  set_irq_callback - install a driver-specific
 //  callback for IRQ acknowledge
@@ -540,6 +613,53 @@ void device_execute_interface::execute_set_input(int linenum, int state)
 }
 
 
+//-------------------------------------------------
+//  idle_list_match - return true if a comma-
+//  separated list of drivers names this device;
+//  entries are a driver, one of its parents or
+//  its source file without the extension, or *
+//  for all drivers, optionally followed by :tag
+//  to select a single CPU
+//-------------------------------------------------
+
+static bool idle_list_match(const char *list, const game_driver *gamedrv, const char *tag)
+{
+	if (list == NULL)
+		return false;
+
+	astring source;
+	core_filename_extract_base(&source, gamedrv->source_file, TRUE);
+
+	while (*list != 0)
+	{
+		// split off the next entry and its optional tag
+		int length = strcspn(list, ",");
+		astring name;
+		name.cpy(list, length).trimspace();
+		list += length + (list[length] == ',');
+
+		int colon = name.chr(0, ':');
+		if (colon != -1)
+		{
+			astring cputag;
+			cputag.cpy(name.cstr() + colon + 1).trimspace();
+			if (cputag != tag)
+				continue;
+			name.substr(0, colon).trimspace();
+		}
+		if (name.len() == 0)
+			continue;
+
+		if (name == "*" || name == source)
+			return true;
+		for (const game_driver *driver = gamedrv; driver != NULL; driver = driver_get_clone(driver))
+			if (name == driver->name)
+				return true;
+	}
+	return false;
+}
+
+
 //-------------------------------------------------
 //  interface_pre_start - work to be done prior to
 //  actually starting a device
@@ -553,6 +673,16 @@ void device_execute_interface::interface_pre_start()
 	m_profiler = profile_type(index + PROFILER_DEVICE_FIRST);
 	m_inttrigger = index + TRIGGER_INT;
 
+	// idle loop detection is opt-in, and never used under the debugger
+	if (options_get_bool(m_machine.options(), OPTION_IDLE_SKIP) && (m_machine.debug_flags & DEBUG_FLAG_ENABLED) == 0)
+	{
+		const char *tag = m_device.tag();
+		m_idle_detect = idle_list_match(options_get_string(m_machine.options(), OPTION_IDLE_SKIP_ALLOW), m_machine.gamedrv, tag) &&
+						!idle_list_match(options_get_string(m_machine.options(), OPTION_IDLE_SKIP_DENY), m_machine.gamedrv, tag);
+		if (m_idle_detect)
+			mame_printf_verbose("Idle loop detection enabled for %s\n", tag);
+	}
+
 	// fill in the input states and IRQ callback information
 	for (int line = 0; line < ARRAY_LENGTH(m_input); line++)
 		m_input[line].start(this, line);
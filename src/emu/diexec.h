@@ -61,6 +61,11 @@ const UINT32 SUSPEND_REASON_TIMESLICE	= 0x0020;	// waiting for the next timeslic
 const UINT32 SUSPEND_ANY_REASON 		= ~0;		// all of the above
 
 
+// idle loop detection
+const int IDLE_LOOP_MAX_BYTES			= 32;		// longest backward branch that can close a polling loop
+const int IDLE_LOOP_MAX_REGS			= 24;		// most register words a core can hand to the detector
+
+
 // I/O line states
 enum line_state
 {
@@ -238,6 +243,12 @@ public:
 	void trigger(int trigid);
 	void signal_interrupt_trigger() { trigger(m_inttrigger); }
 
+	// idle loop detection; cores report taken short backward branches
+	bool idle_detection() const { return m_idle_detect; }
+	int idle_loop_branch(offs_t target, UINT32 writes, UINT32 reads, const UINT32 *regs, int count);
+	UINT64 idle_loops_skipped() const { return m_idle_hits; }
+	UINT64 idle_cycles_skipped() const { return m_idle_cycles; }
+
 	// time and cycle accounting
 	attotime local_time() const;
 	UINT64 total_cycles() const;
@@ -343,6 +354,18 @@ protected:
 	UINT32					m_cycles_per_second;		// cycles per second, adjusted for multipliers
 	attoseconds_t			m_attoseconds_per_cycle;	// attoseconds per adjusted clock cycle
 
+	// idle loop detection
+	bool					m_idle_detect;				// true if idle loops may be skipped
+	offs_t					m_idle_target;				// target of the backward branch being watched
+	UINT32					m_idle_writes;				// core write count when it was last taken
+	UINT32					m_idle_reads;				// handler read count when it was last taken
+	int						m_idle_icount;				// icount when it was last taken
+	int						m_idle_period;				// cycles between the last two times
+	int						m_idle_repeats;				// identical iterations seen in a row
+	UINT32					m_idle_regs[IDLE_LOOP_MAX_REGS];	// register state when it was last taken
+	UINT64					m_idle_hits;				// number of times a loop was skipped
+	UINT64					m_idle_cycles;				// total cycles skipped
+
 private:
 	// callbacks
 	static void static_timed_trigger_callback(running_machine *machine, void *ptr, int param);
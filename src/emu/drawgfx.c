@@ -10,9 +10,39 @@
 *********************************************************************/
 
 #include "emu.h"
+#include "emuopts.h"
 #include "drawgfxm.h"
 
 
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+#define GFX_CACHE_EMPTY			0xffffffff	/* no slot for a code, or no code in a slot */
+#define GFX_CACHE_MIN_SLOTS		256			/* fewest tiles a cache holds, so that recently returned data stays valid */
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+/* a fixed slab of decoded tiles for one gfx_element; the least recently used tile is replaced first */
+struct _gfx_tile_cache
+{
+	UINT8 *			slab;				/* decoded tiles, char_modulo bytes each */
+	UINT32			slots;				/* number of tiles the slab holds */
+	UINT32			used;				/* number of slots handed out so far */
+	UINT32 *		codeslot;			/* slot holding each code, or GFX_CACHE_EMPTY */
+	UINT32 *		slotcode;			/* code held by each slot */
+	UINT32 *		prev;				/* links between slots, from the most recently used... */
+	UINT32 *		next;
+	UINT32			head;				/* ...at the head to the least recently used at the tail */
+	UINT32			tail;
+};
+
+
+
 /***************************************************************************
     GLOBAL VARIABLES
 ***************************************************************************/
@@ -29,6 +59,7 @@ UINT8 no_priority_size_is_wrong[2 * (sizeof(NO_PRIORITY) == 3) - 1];
 ***************************************************************************/
 
 void decodechar(const gfx_element *gfx, UINT32 code, const UINT8 *src);
+static gfx_element *alloc_element(running_machine *machine, const gfx_layout *gl, const UINT8 *srcdata, UINT32 total_colors, UINT32 color_base, UINT64 cachebytes);
 
 
 
@@ -76,6 +107,29 @@ INLINE INT32 normalize_yscroll(bitmap_t *bitmap, INT32 yscroll)
     GRAPHICS ELEMENTS
 ***************************************************************************/
 
+/*-------------------------------------------------
+    decoded_size - return the memory needed to
+    decode all of a ROM based graphics element
+-------------------------------------------------*/
+
+static UINT64 decoded_size(running_machine *machine, const gfx_decode_entry *gfxdecode)
+{
+	const region_info *region = (gfxdecode->memory_region != NULL) ? machine->region(gfxdecode->memory_region) : NULL;
+	const gfx_layout *gl = gfxdecode->gfxlayout;
+	UINT32 xscale = (gfxdecode->xscale == 0) ? 1 : gfxdecode->xscale;
+	UINT32 yscale = (gfxdecode->yscale == 0) ? 1 : gfxdecode->yscale;
+	UINT32 total = gl->total;
+
+	/* raw graphics are drawn in place */
+	if (region == NULL || gl->planeoffset[0] == GFX_RAW)
+		return 0;
+
+	if (IS_FRAC(total))
+		total = (8 * region->bytes()) / gl->charincrement * FRAC_NUM(total) / FRAC_DEN(total);
+	return (UINT64)total * gl->width * xscale * gl->height * yscale;
+}
+
+
 /*-------------------------------------------------
     gfx_init - allocate memory for the graphics
     elements referenced by a machine
@@ -84,12 +138,19 @@ INLINE INT32 normalize_yscroll(bitmap_t *bitmap, INT32 yscroll)
 void gfx_init(running_machine *machine)
 {
 	const gfx_decode_entry *gfxdecodeinfo = machine->config->m_gfxdecodeinfo;
+	UINT64 cachebytes = (UINT64)options_get_int(machine->options(), OPTION_GFX_CACHE) * 1024 * 1024;
+	UINT64 decodedbytes = 0;
 	int curgfx;
 
 	/* skip if nothing to do */
 	if (gfxdecodeinfo == NULL)
 		return;
 
+	/* a tile cache is shared between the ROM based elements in proportion to their decoded size */
+	if (cachebytes != 0)
+		for (curgfx = 0; curgfx < MAX_GFX_ELEMENTS && gfxdecodeinfo[curgfx].gfxlayout != NULL; curgfx++)
+			decodedbytes += decoded_size(machine, &gfxdecodeinfo[curgfx]);
+
 	/* loop over all elements */
 	for (curgfx = 0; curgfx < MAX_GFX_ELEMENTS && gfxdecodeinfo[curgfx].gfxlayout != NULL; curgfx++)
 	{
@@ -207,8 +268,9 @@ void gfx_init(running_machine *machine)
 		glcopy.height = height;
 		glcopy.total = total;
 
-		/* allocate the graphics */
-		machine->gfx[curgfx] = gfx_element_alloc(machine, &glcopy, (region_base != NULL) ? region_base + gfxdecode->start : NULL, gfxdecode->total_color_codes, gfxdecode->color_codes_start);
+		/* allocate the graphics, with their share of the tile cache */
+		UINT64 elementcache = (decodedbytes != 0) ? cachebytes * decoded_size(machine, gfxdecode) / decodedbytes : 0;
+		machine->gfx[curgfx] = alloc_element(machine, &glcopy, (region_base != NULL) ? region_base + gfxdecode->start : NULL, gfxdecode->total_color_codes, gfxdecode->color_codes_start, elementcache);
 	}
 }
 
@@ -220,6 +282,18 @@ void gfx_init(running_machine *machine)
 -------------------------------------------------*/
 
 gfx_element *gfx_element_alloc(running_machine *machine, const gfx_layout *gl, const UINT8 *srcdata, UINT32 total_colors, UINT32 color_base)
+{
+	return alloc_element(machine, gl, srcdata, total_colors, color_base, 0);
+}
+
+
+/*-------------------------------------------------
+    alloc_element - allocate a gfx_element,
+    keeping only up to cachebytes of decoded tiles
+    if that is less than all of them
+-------------------------------------------------*/
+
+static gfx_element *alloc_element(running_machine *machine, const gfx_layout *gl, const UINT8 *srcdata, UINT32 total_colors, UINT32 color_base, UINT64 cachebytes)
 {
 	int israw = (gl->planeoffset[0] == GFX_RAW);
 	int planes = gl->planes;
@@ -306,12 +380,29 @@ gfx_element *gfx_element_alloc(running_machine *machine, const gfx_layout *gl, c
 	/* decoded graphics case */
 	else
 	{
+		UINT32 slots = (cachebytes != 0) ? MAX(cachebytes / (gfx->origwidth * gfx->origheight), GFX_CACHE_MIN_SLOTS) : 0;
+
 		/* we get to pick our own modulos */
 		gfx->line_modulo = gfx->origwidth;
 		gfx->char_modulo = gfx->line_modulo * gfx->origheight;
 
-		/* allocate memory for the data */
-		gfx->gfxdata = auto_alloc_array(machine, UINT8, gfx->total_elements * gfx->char_modulo);
+		/* allocate memory for the data, or for as many tiles as the cache holds */
+		if (slots != 0 && slots < gfx->total_elements)
+		{
+			gfx_tile_cache *cache = auto_alloc_clear(machine, gfx_tile_cache);
+
+			cache->slots = slots;
+			cache->slab = auto_alloc_array(machine, UINT8, slots * gfx->char_modulo);
+			cache->codeslot = auto_alloc_array(machine, UINT32, gfx->total_elements);
+			cache->slotcode = auto_alloc_array(machine, UINT32, slots);
+			cache->prev = auto_alloc_array(machine, UINT32, slots);
+			cache->next = auto_alloc_array(machine, UINT32, slots);
+			cache->head = cache->tail = GFX_CACHE_EMPTY;
+			memset(cache->codeslot, 0xff, gfx->total_elements * sizeof(cache->codeslot[0]));
+			gfx->cache = cache;
+		}
+		else
+			gfx->gfxdata = auto_alloc_array(machine, UINT8, gfx->total_elements * gfx->char_modulo);
 	}
 
 	return gfx;
@@ -329,6 +420,96 @@ void gfx_element_decode(const gfx_element *gfx, UINT32 code)
 }
 
 
+/*-------------------------------------------------
+    cache_touch - make a slot the most recently
+    used one
+-------------------------------------------------*/
+
+static void cache_touch(gfx_tile_cache *cache, UINT32 slot)
+{
+	if (cache->head == slot)
+		return;
+
+	/* unlink it, unless it is new */
+	if (cache->prev[slot] != GFX_CACHE_EMPTY)
+	{
+		cache->next[cache->prev[slot]] = cache->next[slot];
+		if (cache->next[slot] != GFX_CACHE_EMPTY)
+			cache->prev[cache->next[slot]] = cache->prev[slot];
+		else
+			cache->tail = cache->prev[slot];
+	}
+
+	/* and put it at the head */
+	cache->prev[slot] = GFX_CACHE_EMPTY;
+	cache->next[slot] = cache->head;
+	if (cache->head != GFX_CACHE_EMPTY)
+		cache->prev[cache->head] = slot;
+	else
+		cache->tail = slot;
+	cache->head = slot;
+}
+
+
+/*-------------------------------------------------
+    cache_slot - return the slot for a code,
+    replacing the least recently used tile if it
+    has none
+-------------------------------------------------*/
+
+static UINT32 cache_slot(const gfx_element *gfx, UINT32 code)
+{
+	gfx_tile_cache *cache = gfx->cache;
+	UINT32 slot = cache->codeslot[code];
+
+	if (slot == GFX_CACHE_EMPTY)
+	{
+		/* fill the slab before replacing anything */
+		if (cache->used < cache->slots)
+		{
+			slot = cache->used++;
+			cache->prev[slot] = cache->next[slot] = GFX_CACHE_EMPTY;
+		}
+		else
+		{
+			slot = cache->tail;
+			cache->codeslot[cache->slotcode[slot]] = GFX_CACHE_EMPTY;
+		}
+		cache->codeslot[code] = slot;
+		cache->slotcode[slot] = code;
+	}
+
+	cache_touch(cache, slot);
+	return slot;
+}
+
+
+/*-------------------------------------------------
+    gfx_element_get_cached_data - return the
+    decoded data of a code in a gfx_element that
+    caches its tiles, decoding it on a miss
+-------------------------------------------------*/
+
+UINT8 *gfx_element_get_cached_data(const gfx_element *gfx, UINT32 code)
+{
+	gfx_tile_cache *cache = gfx->cache;
+	UINT32 slot = cache->codeslot[code];
+
+	if (slot != GFX_CACHE_EMPTY && !gfx->dirty[code])
+	{
+		g_profiler.count(PROFILER_COUNTER_GFX_CACHE_HIT);
+		cache_touch(cache, slot);
+	}
+	else
+	{
+		g_profiler.count(PROFILER_COUNTER_GFX_CACHE_MISS);
+		decodechar(gfx, code, gfx->srcdata);
+		slot = cache->codeslot[code];
+	}
+	return cache->slab + slot * gfx->char_modulo;
+}
+
+
 /*-------------------------------------------------
     gfx_element_free - free a gfx_element
 -------------------------------------------------*/
@@ -345,6 +526,15 @@ void gfx_element_free(gfx_element *gfx)
 	auto_free(gfx->machine, gfx->pen_usage);
 	auto_free(gfx->machine, gfx->dirty);
 	auto_free(gfx->machine, gfx->gfxdata);
+	if (gfx->cache != NULL)
+	{
+		auto_free(gfx->machine, gfx->cache->next);
+		auto_free(gfx->machine, gfx->cache->prev);
+		auto_free(gfx->machine, gfx->cache->slotcode);
+		auto_free(gfx->machine, gfx->cache->codeslot);
+		auto_free(gfx->machine, gfx->cache->slab);
+		auto_free(gfx->machine, gfx->cache);
+	}
 	auto_free(gfx->machine, gfx);
 }
 
@@ -381,6 +571,7 @@ void gfx_element_build_temporary(gfx_element *gfx, running_machine *machine, UIN
 	gfx->srcdata = base;
 	gfx->dirty = &not_dirty;
 	gfx->dirtyseq = 0;
+	gfx->cache = NULL;
 
 	gfx->machine = machine;
 }
@@ -391,9 +582,8 @@ void gfx_element_build_temporary(gfx_element *gfx, running_machine *machine, UIN
     a given graphics tile
 -------------------------------------------------*/
 
-static void calc_penusage(const gfx_element *gfx, UINT32 code)
+static void calc_penusage(const gfx_element *gfx, UINT32 code, const UINT8 *dp)
 {
-	const UINT8 *dp = gfx->gfxdata + code * gfx->char_modulo;
 	UINT32 usage = 0;
 	int x, y;
 
@@ -443,7 +633,8 @@ void decodechar(const gfx_element *gfx, UINT32 code, const UINT8 *src)
 	const UINT32 *poffset = gl->planeoffset;
 	const UINT32 *xoffset = gl->extxoffs ? gl->extxoffs : gl->xoffset;
 	const UINT32 *yoffset = gl->extyoffs ? gl->extyoffs : gl->yoffset;
-	UINT8 *dp = gfx->gfxdata + code * gfx->char_modulo;
+	UINT8 *base = (gfx->cache != NULL) ? gfx->cache->slab + cache_slot(gfx, code) * gfx->char_modulo : gfx->gfxdata + code * gfx->char_modulo;
+	UINT8 *dp = base;
 	int plane, x, y;
 
 	if (!israw)
@@ -463,7 +654,7 @@ void decodechar(const gfx_element *gfx, UINT32 code, const UINT8 *src)
 				{
 					int yoffs = planeoffs + yoffset[y];
 
-					dp = gfx->gfxdata + code * gfx->char_modulo + y * gfx->line_modulo;
+					dp = base + y * gfx->line_modulo;
 					for (x = 0; x < gfx->origwidth; x += 2)
 					{
 						if (readbit(src, yoffs + xoffset[x + 0]))
@@ -486,7 +677,7 @@ void decodechar(const gfx_element *gfx, UINT32 code, const UINT8 *src)
 				{
 					int yoffs = planeoffs + yoffset[y];
 
-					dp = gfx->gfxdata + code * gfx->char_modulo + y * gfx->line_modulo;
+					dp = base + y * gfx->line_modulo;
 					for (x = 0; x < gfx->origwidth; x++)
 						if (readbit(src, yoffs + xoffset[x]))
 							dp[x] |= planebit;
@@ -495,7 +686,7 @@ void decodechar(const gfx_element *gfx, UINT32 code, const UINT8 *src)
 		}
 	}
 	/* compute pen usage */
-	calc_penusage(gfx, code);
+	calc_penusage(gfx, code, base);
 
 	/* no longer dirty */
 	gfx->dirty[code] = 0;
@@ -118,6 +118,9 @@ struct _gfx_layout
 };
 
 
+typedef struct _gfx_tile_cache gfx_tile_cache;
+
+
 class gfx_element
 {
 public:
@@ -138,12 +141,13 @@ public:
 
 	UINT32			*pen_usage;			/* bitmask of pens that are used (pens 0-31 only) */
 
-	UINT8			*gfxdata;			/* pixel data, 8bpp or 4bpp (if GFX_ELEMENT_PACKED) */
+	UINT8			*gfxdata;			/* pixel data, 8bpp or 4bpp (if GFX_ELEMENT_PACKED); NULL when cached */
 	UINT32			line_modulo;			/* bytes between each row of data */
 	UINT32			char_modulo;			/* bytes between each element */
 	const UINT8		*srcdata;			/* pointer to the source data for decoding */
 	UINT8			*dirty;				/* dirty array for detecting tiles that need decoding */
 	UINT32			dirtyseq;			/* sequence number; incremented each time a tile is dirtied */
+	gfx_tile_cache	*cache;				/* decoded tiles, if only the recently used ones are kept */
 
 	running_machine *machine;				/* pointer to the owning machine */
 	gfx_layout		layout;				/* copy of the original layout */
@@ -179,6 +183,9 @@ gfx_element *gfx_element_alloc(running_machine *machine, const gfx_layout *gl, c
 /* update a single code in a gfx_element */
 void gfx_element_decode(const gfx_element *gfx, UINT32 code);
 
+/* return the decoded data of a code in a cached gfx_element, decoding it if needed */
+UINT8 *gfx_element_get_cached_data(const gfx_element *gfx, UINT32 code);
+
 /* free a gfx_element */
 void gfx_element_free(gfx_element *gfx);
 
@@ -349,6 +356,8 @@ INLINE void gfx_element_set_source(gfx_element *gfx, const UINT8 *source)
 INLINE const UINT8 *gfx_element_get_data(const gfx_element *gfx, UINT32 code)
 {
 	assert(code < gfx->total_elements);
+	if (gfx->cache != NULL)
+		return gfx_element_get_cached_data(gfx, code) + gfx->starty * gfx->line_modulo + gfx->startx;
 	if (gfx->dirty[code])
 		gfx_element_decode(gfx, code);
 	return gfx->gfxdata + code * gfx->char_modulo + gfx->starty * gfx->line_modulo + gfx->startx;
@@ -104,6 +104,7 @@ typedef device_config *(*machine_config_constructor)(machine_config &config, dev
 
 // machine-wide utilities
 #include "romload.h"
+#include "rgncache.h"
 #include "state.h"
 
 // image-related
@@ -58,6 +58,7 @@ const options_entry mame_core_options[] =
 	{ "snapshot_directory",          "snap",      0,                 "directory to save screenshots" },
 	{ "diff_directory",              "diff",      0,                 "directory to save hard drive image difference files" },
 	{ "comment_directory",           "comments",  0,                 "directory to save debugger comments" },
+	{ "rgncache_directory",          "",          0,                 "directory to save decrypted ROM region caches and ROM hashes; empty disables both" },
 
 	/* state/playback options */
 	{ NULL,                          NULL,        OPTION_HEADER,     "CORE STATE/PLAYBACK OPTIONS" },
@@ -82,6 +83,11 @@ const options_entry mame_core_options[] =
 	{ "sleep",                       "0",         OPTION_BOOLEAN,    "enable sleeping, which gives time back to other applications when idle" },
 	{ "speed(0.01-100)",             "1.0",       0,                 "controls the speed of gameplay, relative to realtime; smaller numbers are slower" },
 	{ "refreshspeed;rs",             "0",         OPTION_BOOLEAN,    "automatically adjusts the speed of gameplay to keep the refresh rate lower than the screen" },
+	{ "region_cache",                "0",         OPTION_BOOLEAN,    "keep decrypted and converted ROM regions on disk to speed up the next start" },
+	{ "gfx_cache",                   "0",         0,                 "megabytes of decoded ROM graphics to keep, decoding the rest on use; 0 keeps all of them" },
+	{ "idle_skip",                   "0",         OPTION_BOOLEAN,    "skip CPU polling loops that cannot end before an interrupt or another device intervenes" },
+	{ "idle_skip_allow",             "*",         0,                 "comma-separated drivers, parents or source files (optionally :cputag) idle_skip applies to; * for all" },
+	{ "idle_skip_deny",              NULL,        0,                 "comma-separated drivers, parents or source files (optionally :cputag) idle_skip never applies to" },
 
 	/* rotation options */
 	{ NULL,                          NULL,        OPTION_HEADER,     "CORE ROTATION OPTIONS" },
@@ -120,6 +126,8 @@ const options_entry mame_core_options[] =
 	{ "samplerate;sr(1000-1000000)", "48000",     0,                 "set sound output sample rate" },
 	{ "samples",                     "1",         OPTION_BOOLEAN,    "enable the use of external samples if available" },
 	{ "volume;vol",                  "0",         0,                 "sound volume in decibels (-32 min, 0 max)" },
+	{ "resampler",                   "medium",    0,                 "sample rate conversion quality: fast (linear), medium or high (windowed sinc)" },
+	{ "sound_worker",                "0",         OPTION_BOOLEAN,    "generate sound chips on a worker thread, queueing the register writes that drive them" },
 
 	/* input options */
 	{ NULL,                          NULL,        OPTION_HEADER,     "CORE INPUT OPTIONS" },
@@ -63,6 +63,7 @@
 #define OPTION_SNAPSHOT_DIRECTORY	"snapshot_directory"
 #define OPTION_DIFF_DIRECTORY		"diff_directory"
 #define OPTION_COMMENT_DIRECTORY	"comment_directory"
+#define OPTION_RGNCACHE_DIRECTORY	"rgncache_directory"
 
 /* core state/playback options */
 #define OPTION_STATE				"state"
@@ -85,6 +86,11 @@
 #define OPTION_SLEEP				"sleep"
 #define OPTION_SPEED				"speed"
 #define OPTION_REFRESHSPEED			"refreshspeed"
+#define OPTION_REGION_CACHE			"region_cache"
+#define OPTION_GFX_CACHE			"gfx_cache"
+#define OPTION_IDLE_SKIP			"idle_skip"
+#define OPTION_IDLE_SKIP_ALLOW		"idle_skip_allow"
+#define OPTION_IDLE_SKIP_DENY		"idle_skip_deny"
 
 /* core rotation options */
 #define OPTION_ROTATE				"rotate"
@@ -118,6 +124,8 @@
 #define OPTION_SAMPLERATE			"samplerate"
 #define OPTION_SAMPLES				"samples"
 #define OPTION_VOLUME				"volume"
+#define OPTION_RESAMPLER			"resampler"
+#define OPTION_SOUND_WORKER			"sound_worker"
 
 /* core input options */
 #define OPTION_COIN_LOCKOUT			"coin_lockout"
@@ -58,6 +58,8 @@ struct _mame_file
 	zip_file *		zipfile;						/* ZIP file pointer */
 	UINT8 *			zipdata;						/* ZIP file data */
 	UINT64			ziplength;						/* ZIP file length */
+	astring			container;						/* ZIP file the data came from */
+	astring			member;							/* name of the data in the ZIP file */
 };
 
 
@@ -333,6 +335,8 @@ static file_error fopen_attempt_zipped(astring &fullname, UINT32 crc, UINT32 ope
 
 			file->zipfile = zip;
 			file->ziplength = header->uncompressed_length;
+			file->container.cpy(zip->filename);
+			file->member.cpy(header->filename, header->filename_length);
 
 			/* build a hash with just the CRC */
 			hash_data_clear(file->hash);
@@ -516,6 +520,28 @@ UINT32 mame_fread(mame_file *file, void *buffer, UINT32 length)
 }
 
 
+/*-------------------------------------------------
+    mame_fstream - read a whole file piece by
+    piece without loading it into memory
+-------------------------------------------------*/
+
+file_error mame_fstream(mame_file *file, void *buffer, UINT32 length, mame_stream_func callback, void *param)
+{
+	UINT32 read_length;
+
+	/* ZIP members not loaded yet are decompressed a piece at a time */
+	if (file->zipfile != NULL)
+		return (zip_file_decompress_stream(file->zipfile, buffer, length, callback, param) == ZIPERR_NONE) ? FILERR_NONE : FILERR_FAILURE;
+
+	if (file->file == NULL || core_fseek(file->file, 0, SEEK_SET) != 0)
+		return FILERR_FAILURE;
+
+	while ((read_length = core_fread(file->file, buffer, length)) > 0)
+		(*callback)(param, buffer, read_length);
+	return FILERR_NONE;
+}
+
+
 /*-------------------------------------------------
     mame_fgetc - read a character from a file
 -------------------------------------------------*/
@@ -748,6 +774,28 @@ const astring &mame_file_full_name(mame_file *file)
 }
 
 
+/*-------------------------------------------------
+    mame_file_container_name - return the name of
+    the file on disk holding a given mame_file
+-------------------------------------------------*/
+
+const char *mame_file_container_name(mame_file *file)
+{
+	return (file->container.len() > 0) ? file->container.cstr() : file->filename.cstr();
+}
+
+
+/*-------------------------------------------------
+    mame_file_member_name - return the name of a
+    mame_file within its ZIP file
+-------------------------------------------------*/
+
+const char *mame_file_member_name(mame_file *file)
+{
+	return file->member;
+}
+
+
 /*-------------------------------------------------
     mame_fhash - returns the hash for a file
 -------------------------------------------------*/
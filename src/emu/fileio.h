@@ -52,6 +52,7 @@
 #define SEARCHPATH_SCREENSHOT      OPTION_SNAPSHOT_DIRECTORY
 #define SEARCHPATH_MOVIE           OPTION_SNAPSHOT_DIRECTORY
 #define SEARCHPATH_COMMENT         OPTION_COMMENT_DIRECTORY
+#define SEARCHPATH_RGNCACHE        OPTION_RGNCACHE_DIRECTORY
 
 
 
@@ -64,6 +65,9 @@ typedef struct _mame_path mame_path;
 
 typedef struct _core_options core_options;
 
+/* receives consecutive pieces of a file read by mame_fstream */
+typedef void (*mame_stream_func)(void *param, const void *data, UINT32 length);
+
 
 
 /***************************************************************************
@@ -127,6 +131,12 @@ UINT64 mame_fsize(mame_file *file);
 /* standard binary read from a file */
 UINT32 mame_fread(mame_file *file, void *buffer, UINT32 length);
 
+/* read the whole file from the start, passing it to the callback in pieces of up
+   to length bytes read into buffer; a ZIP member opened with OPEN_FLAG_NO_PRELOAD
+   is decompressed straight into the buffer, and different files may be read this
+   way from several threads at once */
+file_error mame_fstream(mame_file *file, void *buffer, UINT32 length, mame_stream_func callback, void *param);
+
 /* read one character from the file */
 int mame_fgetc(mame_file *file);
 
@@ -172,6 +182,12 @@ core_file *mame_core_file(mame_file *file);
 /* return the full filename for a given mame_file */
 const astring &mame_file_full_name(mame_file *file);
 
+/* return the name of the ZIP file a mame_file was found in, or its own full name */
+const char *mame_file_container_name(mame_file *file);
+
+/* return the name of a mame_file within its ZIP file, or an empty string */
+const char *mame_file_member_name(mame_file *file);
+
 /* return a hash string for the file with the given functions */
 const char *mame_fhash(mame_file *file, UINT32 functions);
 
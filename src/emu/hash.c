@@ -141,24 +141,24 @@ struct _hash_function_desc
 	unsigned int size;          /* checksum size in bytes */
 
 	/* Functions used to calculate the hash of a memory block */
-	void (*calculate_begin)(void);
-	void (*calculate_buffer)(const void* mem, unsigned long len);
-	void (*calculate_end)(UINT8* bin_chksum);
+	void (*calculate_begin)(hash_state* state);
+	void (*calculate_buffer)(hash_state* state, const void* mem, unsigned long len);
+	void (*calculate_end)(hash_state* state, UINT8* bin_chksum);
 
 };
 typedef struct _hash_function_desc hash_function_desc;
 
-static void h_crc_begin(void);
-static void h_crc_buffer(const void* mem, unsigned long len);
-static void h_crc_end(UINT8* chksum);
+static void h_crc_begin(hash_state* state);
+static void h_crc_buffer(hash_state* state, const void* mem, unsigned long len);
+static void h_crc_end(hash_state* state, UINT8* chksum);
 
-static void h_sha1_begin(void);
-static void h_sha1_buffer(const void* mem, unsigned long len);
-static void h_sha1_end(UINT8* chksum);
+static void h_sha1_begin(hash_state* state);
+static void h_sha1_buffer(hash_state* state, const void* mem, unsigned long len);
+static void h_sha1_end(hash_state* state, UINT8* chksum);
 
-static void h_md5_begin(void);
-static void h_md5_buffer(const void* mem, unsigned long len);
-static void h_md5_end(UINT8* chksum);
+static void h_md5_begin(hash_state* state);
+static void h_md5_buffer(hash_state* state, const void* mem, unsigned long len);
+static void h_md5_end(hash_state* state, UINT8* chksum);
 
 static const hash_function_desc hash_descs[HASH_NUM_FUNCTIONS] =
 {
@@ -521,27 +521,51 @@ int hash_data_insert_binary_checksum(char* d, unsigned int function, const UINT8
 
 void hash_compute(char* dst, const unsigned char* data, unsigned long length, unsigned int functions)
 {
-	int i;
+	hash_state state;
 
-	hash_data_clear(dst);
+	hash_begin(&state, functions);
+	hash_buffer(&state, data, length);
+	hash_end(&state, dst);
+}
+
+void hash_begin(hash_state* state, unsigned int functions)
+{
+	int i;
 
 	// Zero means use all the functions
 	if (functions == 0)
 		functions = ~functions;
 
+	state->functions = functions;
+	for (i=0;i<HASH_NUM_FUNCTIONS;i++)
+		if (functions & (1 << i))
+			hash_get_function_desc(1 << i)->calculate_begin(state);
+}
+
+void hash_buffer(hash_state* state, const unsigned char* data, unsigned long length)
+{
+	int i;
+
+	for (i=0;i<HASH_NUM_FUNCTIONS;i++)
+		if (state->functions & (1 << i))
+			hash_get_function_desc(1 << i)->calculate_buffer(state, data, length);
+}
+
+void hash_end(hash_state* state, char* dst)
+{
+	int i;
+
+	hash_data_clear(dst);
+
 	for (i=0;i<HASH_NUM_FUNCTIONS;i++)
 	{
 		unsigned func = 1 << i;
 
-		if (functions & func)
+		if (state->functions & func)
 		{
-			const hash_function_desc* desc = hash_get_function_desc(func);
 			UINT8 chksum[256];
 
-			desc->calculate_begin();
-			desc->calculate_buffer(data, length);
-			desc->calculate_end(chksum);
-
+			hash_get_function_desc(func)->calculate_end(state, chksum);
 			dst += hash_data_add_binary_checksum(dst, func, chksum);
 		}
 	}
@@ -638,59 +662,53 @@ int hash_verify_string(const char *hash)
     Hash functions - Wrappers
  *********************************************************************/
 
-static UINT32 crc;
-
-static void h_crc_begin(void)
+static void h_crc_begin(hash_state* state)
 {
-	crc = 0;
+	state->crc = 0;
 }
 
-static void h_crc_buffer(const void* mem, unsigned long len)
+static void h_crc_buffer(hash_state* state, const void* mem, unsigned long len)
 {
-	crc = crc32(crc, (UINT8*)mem, len);
+	state->crc = crc32(state->crc, (UINT8*)mem, len);
 }
 
-static void h_crc_end(UINT8* bin_chksum)
+static void h_crc_end(hash_state* state, UINT8* bin_chksum)
 {
-	bin_chksum[0] = (UINT8)(crc >> 24);
-	bin_chksum[1] = (UINT8)(crc >> 16);
-	bin_chksum[2] = (UINT8)(crc >> 8);
-	bin_chksum[3] = (UINT8)(crc >> 0);
+	bin_chksum[0] = (UINT8)(state->crc >> 24);
+	bin_chksum[1] = (UINT8)(state->crc >> 16);
+	bin_chksum[2] = (UINT8)(state->crc >> 8);
+	bin_chksum[3] = (UINT8)(state->crc >> 0);
 }
 
 
-static struct sha1_ctx sha1ctx;
-
-static void h_sha1_begin(void)
+static void h_sha1_begin(hash_state* state)
 {
-	sha1_init(&sha1ctx);
+	sha1_init(&state->sha1);
 }
 
-static void h_sha1_buffer(const void* mem, unsigned long len)
+static void h_sha1_buffer(hash_state* state, const void* mem, unsigned long len)
 {
-	sha1_update(&sha1ctx, len, (UINT8*)mem);
+	sha1_update(&state->sha1, len, (UINT8*)mem);
 }
 
-static void h_sha1_end(UINT8* bin_chksum)
+static void h_sha1_end(hash_state* state, UINT8* bin_chksum)
 {
-	sha1_final(&sha1ctx);
-	sha1_digest(&sha1ctx, 20, bin_chksum);
+	sha1_final(&state->sha1);
+	sha1_digest(&state->sha1, 20, bin_chksum);
 }
 
 
-static struct MD5Context md5_ctx;
-
-static void h_md5_begin(void)
+static void h_md5_begin(hash_state* state)
 {
-	MD5Init(&md5_ctx);
+	MD5Init(&state->md5);
 }
 
-static void h_md5_buffer(const void* mem, unsigned long len)
+static void h_md5_buffer(hash_state* state, const void* mem, unsigned long len)
 {
-	MD5Update(&md5_ctx, (md5byte*)mem, len);
+	MD5Update(&state->md5, (md5byte*)mem, len);
 }
 
-static void h_md5_end(UINT8* bin_chksum)
+static void h_md5_end(hash_state* state, UINT8* bin_chksum)
 {
-	MD5Final(bin_chksum, &md5_ctx);
+	MD5Final(bin_chksum, &state->md5);
 }
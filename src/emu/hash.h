@@ -14,6 +14,9 @@
 #ifndef __HASH_H__
 #define __HASH_H__
 
+#include "md5.h"
+#include "sha1.h"
+
 #define HASH_INFO_NO_DUMP	0
 #define HASH_INFO_BAD_DUMP	1
 #define HASH_INFO_VERIFY_OFF	2
@@ -28,6 +31,16 @@
 //  must respect this size
 #define HASH_BUF_SIZE       256
 
+// State of a hash computed piece by piece; independent states may be used from several threads
+typedef struct _hash_state hash_state;
+struct _hash_state
+{
+	unsigned int functions;
+	UINT32 crc;
+	struct sha1_ctx sha1;
+	struct MD5Context md5;
+};
+
 // Get function name of the specified function
 const char* hash_function_name(unsigned int function);
 
@@ -73,6 +86,12 @@ unsigned int hash_data_used_functions(const char* d);
 //  we want the checksum of.
 void hash_compute(char* dst, const unsigned char* data, unsigned long length, unsigned int functions);
 
+// Compute hash of data that arrives in pieces: hash_begin, then hash_buffer for each piece in order,
+//  then hash_end to store the checksums in a hash data.
+void hash_begin(hash_state* state, unsigned int functions);
+void hash_buffer(hash_state* state, const unsigned char* data, unsigned long length);
+void hash_end(hash_state* state, char* dst);
+
 // Verifies that a hash string is valid
 int hash_verify_string(const char *hash);
 
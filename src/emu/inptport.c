@@ -813,9 +813,9 @@ static void save_game_inputs(running_machine *machine, xml_data_node *parentnode
 
 /* input playback */
 static time_t playback_init(running_machine *machine);
-// static void playback_end(running_machine *machine, const char *message);
-// static void playback_frame(running_machine *machine, attotime curtime);
-// static void playback_port(const input_port_config *port);
+static void playback_end(running_machine *machine, const char *message);
+static void playback_frame(running_machine *machine, attotime curtime);
+static void playback_port(const input_port_config *port);
 
 /* input recording */
 static void record_init(running_machine *machine);
@@ -1017,7 +1017,7 @@ time_t input_port_init(running_machine *machine, const input_port_token *tokens)
 static void input_port_exit(running_machine &machine)
 {
 	/* close any playback or recording files */
-//	playback_end(&machine, NULL);
+	playback_end(&machine, NULL);
 //	record_end(&machine, NULL);
 }
 
@@ -2465,8 +2465,8 @@ static void frame_update(running_machine *machine)
 // g_profiler.start(PROFILER_INPUT);
 
 	/* record/playback information about the current frame */
-/*	playback_frame(machine, curtime);
-	record_frame(machine, curtime);	*/
+	playback_frame(machine, curtime);
+/*	record_frame(machine, curtime);	*/
 
 	/* track the duration of the previous frame */
 	portdata->last_delta_nsec = attotime_to_attoseconds(attotime_sub(curtime, portdata->last_frame_time)) / ATTOSECONDS_PER_NANOSECOND;
@@ -2522,8 +2522,8 @@ static void frame_update(running_machine *machine)
 		input_port_update_hook(machine, port, &port->state->digital);
 
 		/* handle playback/record */
-/*		playback_port(port);
-		record_port(port);	*/
+		playback_port(port);
+/*		record_port(port);	*/
 
 		/* call device line changed handlers */
 		newvalue = input_port_read_direct(port);
@@ -4298,7 +4298,7 @@ static void save_game_inputs(running_machine *machine, xml_data_node *parentnode
     playback_read_uint8 - read an 8-bit value
     from the playback file
 -------------------------------------------------*/
-#if 0
+
 static UINT8 playback_read_uint8(running_machine *machine)
 {
 	input_port_private *portdata = machine->input_port_data;
@@ -4370,7 +4370,7 @@ static UINT64 playback_read_uint64(running_machine *machine)
 	/* return the appropriate value */
 	return LITTLE_ENDIANIZE_INT64(result);
 }
-#endif
+
 
 /*-------------------------------------------------
     playback_init - initialize INP playback
@@ -4422,7 +4422,6 @@ static time_t playback_init(running_machine *machine)
 /*-------------------------------------------------
     playback_end - end INP playback
 -------------------------------------------------*/
-#if	0
 
 static void playback_end(running_machine *machine, const char *message)
 {
@@ -4506,6 +4505,7 @@ static void playback_port(const input_port_config *port)
 }
 
 
+#if 0
 /***************************************************************************
     INPUT RECORDING
 ***************************************************************************/
@@ -305,6 +305,7 @@ void running_machine::start()
 	// first load ROMs, then populate memory, and finally initialize CPUs
 	// these operations must proceed in this order
 	rom_init(this);
+	region_cache_init(this);
 	memory_init(this);
 	watchdog_init(this);
 
@@ -335,6 +336,7 @@ void running_machine::start()
 
 	// start up the devices
 	m_devicelist.start_all();
+	region_cache_finish(this);
 
 	// if we're coming in with a savegame request, process it now
 	const char *savegame = options_get_string(&m_options, OPTION_STATE);
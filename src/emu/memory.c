@@ -706,7 +706,7 @@ public:
 	}
 
 	// enable watchpoints by swapping in the watchpoint table
-	void enable_watchpoints(bool enable = true) { m_live_lookup = enable ? s_watchpoint_table : m_table; }
+	void enable_watchpoints(bool enable = true) { m_live_lookup = enable ? s_watchpoint_table : m_table; m_space.m_direct.force_update(); }
 
 	// table mapping helpers
 	UINT8 map_range(offs_t bytestart, offs_t byteend, offs_t bytemask, offs_t bytemirror, UINT8 staticentry = 0);
@@ -936,7 +936,7 @@ public:
 	{
 		// perform the lookup
 		byteaddress &= m_bytemask;
-		UINT32 entry = read_lookup(byteaddress);
+		UINT32 entry = write_lookup(byteaddress);
 		const handler_entry_write &handler = m_write.handler_write(entry);
 
 		// 8-bit case: RAM/ROM
@@ -959,6 +959,7 @@ public:
 		if (entry < STATIC_RAM) result = *reinterpret_cast<_NativeType *>(handler.ramptr(offset));
 		else
 		{
+			m_handler_reads++;
 			switch (sizeof(_NativeType))
 			{
 				case 1: result = handler.read8(*this, offset, mask); break;
@@ -984,6 +985,7 @@ public:
 		if (entry < STATIC_RAM) result = *reinterpret_cast<_NativeType *>(handler.ramptr(offset));
 		else
 		{
+			m_handler_reads++;
 			switch (sizeof(_NativeType))
 			{
 				case 1: result = handler.read8(*this, offset, 0xff); break;
@@ -1676,6 +1678,7 @@ address_space::address_space(device_memory_interface &memory, int spacenum, bool
 	  m_spacenum(spacenum),
 	  m_debugger_access(false),
 	  m_log_unmap(true),
+	  m_handler_reads(0),
 	  m_direct(*auto_alloc(memory.device().machine, direct_read_data(*this))),
 	  m_name(memory.space_config(spacenum)->name()),
 	  m_addrchars((m_config.m_databus_width + 3) / 4),
@@ -2227,6 +2230,38 @@ const char *address_space::get_handler_string(read_or_write readorwrite, offs_t
 }
 
 
+//-------------------------------------------------
+//  get_direct_page - return a pointer to the RAM
+//  backing an aligned page, if the whole page
+//  maps linearly onto a single bank; the result
+//  stays valid until the map generation changes
+//-------------------------------------------------
+
+UINT8 *address_space::get_direct_page(read_or_write readorwrite, offs_t bytestart, offs_t byteend)
+{
+	const address_table &table = (readorwrite == ROW_READ) ? static_cast<address_table &>(read()) : static_cast<address_table &>(write());
+	offs_t pagemask = byteend - bytestart;
+
+	// watchpoints need every access to go through the handlers
+	if (table.watchpoints_enabled())
+		return NULL;
+
+	// the entire page must belong to one bank entry
+	offs_t rangestart, rangeend;
+	UINT8 entry = table.derive_range(bytestart & m_bytemask, rangestart, rangeend);
+	if (entry < STATIC_BANK1 || entry >= STATIC_RAM)
+		return NULL;
+	if (rangestart > (bytestart & m_bytemask) || rangeend < (byteend & m_bytemask))
+		return NULL;
+
+	// and the handler offsets must not wrap inside it
+	const handler_entry &handler = table.handler(entry);
+	if ((handler.bytemask() & pagemask) != pagemask || (handler.bytestart() & pagemask) != 0)
+		return NULL;
+	return handler.ramptr(handler.byteoffset(bytestart & m_bytemask));
+}
+
+
 //-------------------------------------------------
 //  dump_map - dump the contents of a single
 //  address space
@@ -2981,7 +3016,9 @@ UINT8 address_table::map_range(offs_t addrstart, offs_t addrend, offs_t addrmask
 	// populate it
 	populate_range_mirrored(bytestart, byteend, bytemirror, entry);
 
-	// recompute any direct access on this space if it is a read modification
+	// recompute any direct access on this space if it is a read modification;
+	// cached pages elsewhere in the space may be affected either way
+	m_space.m_direct.invalidate_map();
 	m_space.m_direct.force_update(entry);
 	return entry;
 }
@@ -3677,7 +3714,8 @@ direct_read_data::direct_read_data(address_space &space)
 	  m_bytemask(space.bytemask()),
 	  m_bytestart(1),
 	  m_byteend(0),
-	  m_entry(STATIC_UNMAP)
+	  m_entry(STATIC_UNMAP),
+	  m_mapgeneration(0)
 {
 }
 
@@ -4027,6 +4065,10 @@ void memory_bank::set_entry(int entrynum)
 	if (m_entry[entrynum].m_raw == NULL)
 		throw emu_fatalerror("memory_bank::set_entry called for bank '%s' with invalid bank entry %d", m_tag.cstr(), entrynum);
 
+	// nothing to do if the bank already points there
+	if (m_curentry == entrynum && *m_baseptr == m_entry[entrynum].m_raw && *m_basedptr == m_entry[entrynum].m_decrypted)
+		return;
+
 	// set both raw and decrypted values
 	m_curentry = entrynum;
 	*m_baseptr = m_entry[entrynum].m_raw;
@@ -241,14 +241,18 @@ public:
 	address_space &space() const { return m_space; }
 	UINT8 *raw() const { return m_raw; }
 	UINT8 *decrypted() const { return m_decrypted; }
+	UINT32 map_generation() const { return m_mapgeneration; }
 
 	// see if an address is within bounds, or attempt to update it if not
 	bool address_is_valid(offs_t byteaddress) { return EXPECTED(byteaddress >= m_bytestart && byteaddress <= m_byteend) || set_direct_region(byteaddress); }
 
-	// force a recomputation on the next read
-	void force_update() { m_byteend = 0; m_bytestart = 1; }
+	// force a recomputation on the next read; this also bumps the map generation
+	void force_update() { m_byteend = 0; m_bytestart = 1; m_mapgeneration++; }
 	void force_update(UINT8 if_match) { if (m_entry == if_match) force_update(); }
 
+	// note that some entry of the space changed, even if not the live one
+	void invalidate_map() { m_mapgeneration++; }
+
 	// custom update callbacks and configuration
 	direct_update_delegate set_direct_update(direct_update_delegate function);
 	void explicit_configure(offs_t bytestart, offs_t byteend, offs_t bytemask, void *raw, void *decrypted = NULL);
@@ -281,6 +285,7 @@ private:
 	offs_t				m_bytestart;			// minimum valid byte address
 	offs_t				m_byteend;			// maximum valid byte address
 	UINT8						m_entry;	// live entry
+	UINT32						m_mapgeneration;	// bumped whenever any part of the mapping may have changed
 	simple_list<direct_range> 		m_rangelist[256];	// list of ranges for each entry
 	simple_list<direct_range> 		m_freerangelist;	// list of recycled range entries
 	direct_update_delegate			m_directupdate;		// fast direct-access update callback
@@ -364,6 +369,7 @@ public:
 	offs_t logaddrmask() const { return m_logaddrmask; }
 	offs_t logbytemask() const { return m_logbytemask; }
 	UINT8 logaddrchars() const { return m_logaddrchars; }
+	UINT32 handler_reads() const { return m_handler_reads; }
 
 	// debug helpers
 	const char *get_handler_string(read_or_write readorwrite, offs_t byteaddress);
@@ -381,6 +387,7 @@ public:
 	virtual void accessors(data_accessors &accessors) const = 0;
 	virtual void *get_read_ptr(offs_t byteaddress) = 0;
 	virtual void *get_write_ptr(offs_t byteaddress) = 0;
+	UINT8 *get_direct_page(read_or_write readorwrite, offs_t bytestart, offs_t byteend);
 
 	// read accessors
 	virtual UINT8 read_byte(offs_t byteaddress) = 0;
@@ -511,6 +518,7 @@ protected:
 	UINT8					m_spacenum;		// address space index
 	bool					m_debugger_access;	// treat accesses as coming from the debugger
 	bool					m_log_unmap;		// log unmapped accesses in this space?
+	UINT32					m_handler_reads;	// reads that went to a handler rather than RAM/ROM
 	direct_read_data		&m_direct;			// fast direct-access read info
 	const char			*m_name;			// friendly name of the address space
 	UINT8					m_addrchars;		// number of characters to use for physical addresses
@@ -196,6 +196,12 @@ const char *real_profiler_state::text(running_machine &machine, astring &string)
 		{ PROFILER_IDLE,             "Idle" }
 	};
 
+	static const char *const counter_names[PROFILER_COUNTER_TOTAL] =
+	{
+		"gfx cache hits",
+		"gfx cache misses"
+	};
+
 	g_profiler.start(PROFILER_PROFILER);
 
 	// compute the total time for all bits, not including profiler or idle
@@ -261,6 +267,16 @@ const char *real_profiler_state::text(running_machine &machine, astring &string)
 		for (int curmem = 0; curmem < ARRAY_LENGTH(m_data); curmem++)
 			switches += m_data[curmem].context_switches;
 		string.catprintf("%d CPU switches\n", switches / (int) ARRAY_LENGTH(m_data));
+
+		// and any counters in use
+		for (int counter = 0; counter < PROFILER_COUNTER_TOTAL; counter++)
+		{
+			UINT64 count = 0;
+			for (int curmem = 0; curmem < ARRAY_LENGTH(m_data); curmem++)
+				count += m_data[curmem].counts[counter];
+			if (count != 0)
+				string.catprintf("%d %s\n", (int)(count / ARRAY_LENGTH(m_data)), counter_names[counter]);
+		}
 	}
 
 	// advance to the next dataset and reset it to 0
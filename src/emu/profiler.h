@@ -89,6 +89,14 @@ enum profile_type
 DECLARE_ENUM_OPERATORS(profile_type);
 
 
+enum profile_counter
+{
+	PROFILER_COUNTER_GFX_CACHE_HIT,		// decoded tile found in a gfx_element tile cache
+	PROFILER_COUNTER_GFX_CACHE_MISS,	// tile decoded into a gfx_element tile cache
+	PROFILER_COUNTER_TOTAL
+};
+
+
 
 //*************************************************************************/
 //  TYPE DEFINITIONS
@@ -127,6 +135,9 @@ public:
 	void start(profile_type type) { if (m_enabled) real_start(type); }
 	void stop() { if (m_enabled) real_stop(); }
 
+	// event counting
+	void count(profile_counter counter, UINT32 amount = 1) { if (m_enabled) m_data[m_dataindex].counts[counter] += amount; }
+
 private:
 	void real_start(profile_type type);
 	void real_stop();
@@ -142,6 +153,7 @@ private:
 	struct history_data
 	{
 		UINT32			context_switches;			// number of context switches seen
+		UINT32			counts[PROFILER_COUNTER_TOTAL];	// number of events of each kind seen
 		osd_ticks_t		duration[PROFILER_TOTAL];	// duration spent in each entry
 	};
 
@@ -173,6 +185,9 @@ public:
 	// start/stop
 	void start(profile_type type) { }
 	void stop() { }
+
+	// event counting
+	void count(profile_counter counter, UINT32 amount = 1) { }
 };
 
 
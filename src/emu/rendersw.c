@@ -54,6 +54,20 @@
 #include "video/rgbutil.h"
 #include "render.h"
 
+/* pick a vector unit the same way rgbutil.h does; define RENDERSW_NO_SIMD */
+/* to force the scalar paths. The NEON kernels are unverified, so ARM builds */
+/* stay scalar unless RENDERSW_NEON_EXPERIMENTAL is defined; retrobench */
+/* -spans checks them against their plain C forms */
+#if !defined(RENDERSW_NO_SIMD)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define RENDERSW_SSE2
+#elif defined(RENDERSW_NEON_EXPERIMENTAL) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#define RENDERSW_NEON
+#endif
+#endif
+
 
 
 /***************************************************************************
@@ -68,6 +82,10 @@
 #define IS_OPAQUE(a)		(a >= (NO_DEST_READ ? 0.5f : 1.0f))
 #define IS_TRANSPARENT(a)	(a <  (NO_DEST_READ ? 0.5f : 0.0001f))
 
+#define MAX_RENDER_BANDS	16		/* maximum number of horizontal bands */
+#define MIN_BAND_HEIGHT		16		/* don't split below this many rows per band */
+#define SPAN_CHUNK			64		/* pixels gathered per span conversion */
+
 #undef	COMMON_PART
 #define	COMMON_PART		\
 				INT32 u0, u1, v0, v1;						\
@@ -109,6 +127,18 @@ struct _quad_setup_data
 	INT32		endy;
 };
 
+typedef struct _render_band_data render_band_data;
+struct _render_band_data
+{
+	const render_primitive_list *primlist;	/* list being drawn */
+	void *		dstdata;					/* destination surface */
+	INT32		width;						/* surface width */
+	INT32		height;						/* surface height */
+	UINT32		pitch;						/* surface pitch, in pixels */
+	INT32		miny;						/* first row of the band */
+	INT32		maxy;						/* one past the last row of the band */
+};
+
 
 
 /***************************************************************************
@@ -123,6 +153,20 @@ static UINT32 cosine_table[2049];
     INLINE FUNCTIONS
 ***************************************************************************/
 
+/*-------------------------------------------------
+    build_cosine_table - build up the cosine table
+    used by antialiased lines if we haven't yet;
+    done up front so that bands never race on it
+-------------------------------------------------*/
+
+INLINE void build_cosine_table(void)
+{
+	if (cosine_table[0] == 0)
+		for (int entry = 2048; entry >= 0; entry--)
+			cosine_table[entry] = (int)((double)(1.0 / cos(atan((double)(entry) / 2048.0))) * 0x10000000 + 0.5);
+}
+
+
 /*-------------------------------------------------
     round_nearest - round to nearest in a
     predictable way
@@ -451,6 +495,254 @@ INLINE UINT32 get_texel_argb32_bilinear(const render_texinfo *texture, INT32 cur
 }
 
 
+/***************************************************************************
+    VECTOR SPAN HELPERS
+***************************************************************************/
+
+/* each helper has a plain C form, suffixed _c, that also finishes the tail; */
+/* conversions the compiler vectorizes unaided only have that form */
+
+/*-------------------------------------------------
+    span_rgb32_to_rgb565 - convert a span of
+    xRGB32 pixels to RGB565
+-------------------------------------------------*/
+
+INLINE void span_rgb32_to_rgb565_c(UINT16 *dest, const UINT32 *src, INT32 count)
+{
+	for (INT32 x = 0; x < count; x++)
+	{
+		UINT32 pix = src[x];
+		dest[x] = ((pix >> 8) & 0xf800) | ((pix >> 5) & 0x07e0) | ((pix >> 3) & 0x001f);
+	}
+}
+
+INLINE void span_rgb32_to_rgb565(UINT16 *dest, const UINT32 *src, INT32 count)
+{
+	INT32 x = 0;
+
+#if defined(RENDERSW_SSE2)
+	const __m128i rmask = _mm_set1_epi32(0xf800);
+	const __m128i gmask = _mm_set1_epi32(0x07e0);
+	const __m128i bmask = _mm_set1_epi32(0x001f);
+
+	for ( ; x + 8 <= count; x += 8)
+	{
+		__m128i lo = _mm_loadu_si128((const __m128i *)&src[x]);
+		__m128i hi = _mm_loadu_si128((const __m128i *)&src[x + 4]);
+
+		lo = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(lo, 8), rmask), _mm_and_si128(_mm_srli_epi32(lo, 5), gmask)), _mm_and_si128(_mm_srli_epi32(lo, 3), bmask));
+		hi = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(hi, 8), rmask), _mm_and_si128(_mm_srli_epi32(hi, 5), gmask)), _mm_and_si128(_mm_srli_epi32(hi, 3), bmask));
+
+		/* sign-extend so that the saturating pack passes all 16 bits through */
+		lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+		hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+		_mm_storeu_si128((__m128i *)&dest[x], _mm_packs_epi32(lo, hi));
+	}
+#elif defined(RENDERSW_NEON)
+	const uint32x4_t rmask = vdupq_n_u32(0xf800);
+	const uint32x4_t gmask = vdupq_n_u32(0x07e0);
+	const uint32x4_t bmask = vdupq_n_u32(0x001f);
+
+	for ( ; x + 8 <= count; x += 8)
+	{
+		uint32x4_t lo = vld1q_u32(&src[x]);
+		uint32x4_t hi = vld1q_u32(&src[x + 4]);
+
+		lo = vorrq_u32(vorrq_u32(vandq_u32(vshrq_n_u32(lo, 8), rmask), vandq_u32(vshrq_n_u32(lo, 5), gmask)), vandq_u32(vshrq_n_u32(lo, 3), bmask));
+		hi = vorrq_u32(vorrq_u32(vandq_u32(vshrq_n_u32(hi, 8), rmask), vandq_u32(vshrq_n_u32(hi, 5), gmask)), vandq_u32(vshrq_n_u32(hi, 3), bmask));
+		vst1q_u16(&dest[x], vcombine_u16(vmovn_u32(lo), vmovn_u32(hi)));
+	}
+#endif
+
+	span_rgb32_to_rgb565_c(dest + x, src + x, count - x);
+}
+
+
+/*-------------------------------------------------
+    span_rgb15_to_rgb565_c - convert a span of
+    RGB15 pixels to RGB565; the compiler
+    vectorizes the plain loop as well as SSE2
+    does, so there is only a C form
+-------------------------------------------------*/
+
+INLINE void span_rgb15_to_rgb565_c(UINT16 *dest, const UINT16 *src, INT32 count)
+{
+	for (INT32 x = 0; x < count; x++)
+	{
+		UINT32 pix = src[x];
+		dest[x] = ((pix & 0x7fe0) << 1) | (pix & 0x001f);
+	}
+}
+
+
+/*-------------------------------------------------
+    span_rgb15_to_rgb888_c - convert a span of
+    RGB15 pixels to xRGB32; the compiler
+    vectorizes the plain loop as well as SSE2
+    does, so there is only a C form
+-------------------------------------------------*/
+
+INLINE void span_rgb15_to_rgb888_c(UINT32 *dest, const UINT16 *src, INT32 count)
+{
+	for (INT32 x = 0; x < count; x++)
+	{
+		UINT32 pix = src[x];
+		dest[x] = ((pix << 9) & 0xf80000) | ((pix << 6) & 0x00f800) | ((pix << 3) & 0x0000f8);
+	}
+}
+
+
+/*-------------------------------------------------
+    span_argb32_blend_rgb888 - alpha blend a span
+    of ARGB32 pixels over xRGB32; fully
+    transparent source pixels leave the
+    destination untouched
+-------------------------------------------------*/
+
+INLINE void span_argb32_blend_rgb888_c(UINT32 *dest, const UINT32 *src, INT32 count)
+{
+	for (INT32 x = 0; x < count; x++)
+	{
+		UINT32 pix = src[x];
+		UINT32 ta = pix >> 24;
+		if (ta != 0)
+		{
+			UINT32 dpix = dest[x];
+			UINT32 invta = 0x100 - ta;
+			UINT32 r = (((pix >> 16) & 0xff) * ta + ((dpix >> 16) & 0xff) * invta) >> 8;
+			UINT32 g = (((pix >> 8) & 0xff) * ta + ((dpix >> 8) & 0xff) * invta) >> 8;
+			UINT32 b = (((pix >> 0) & 0xff) * ta + ((dpix >> 0) & 0xff) * invta) >> 8;
+			dest[x] = (r << 16) | (g << 8) | b;
+		}
+	}
+}
+
+INLINE void span_argb32_blend_rgb888(UINT32 *dest, const UINT32 *src, INT32 count)
+{
+	INT32 x = 0;
+
+#if defined(RENDERSW_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i full = _mm_set1_epi16(0x100);
+	const __m128i rgbmask = _mm_set1_epi32(0x00ffffff);
+	const __m128i amask = _mm_set1_epi32(0xff000000);
+
+	for ( ; x + 4 <= count; x += 4)
+	{
+		__m128i spix = _mm_loadu_si128((const __m128i *)&src[x]);
+		__m128i dpix = _mm_loadu_si128((const __m128i *)&dest[x]);
+		__m128i slo = _mm_unpacklo_epi8(spix, zero);
+		__m128i shi = _mm_unpackhi_epi8(spix, zero);
+		__m128i talo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(slo, 0xff), 0xff);
+		__m128i tahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(shi, 0xff), 0xff);
+		__m128i lo, hi, keep;
+
+		/* (s * ta + d * (0x100 - ta)) >> 8 never exceeds 16 bits */
+		lo = _mm_add_epi16(_mm_mullo_epi16(slo, talo), _mm_mullo_epi16(_mm_unpacklo_epi8(dpix, zero), _mm_sub_epi16(full, talo)));
+		hi = _mm_add_epi16(_mm_mullo_epi16(shi, tahi), _mm_mullo_epi16(_mm_unpackhi_epi8(dpix, zero), _mm_sub_epi16(full, tahi)));
+		lo = _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+
+		/* blended pixels get a zero top byte, skipped ones keep theirs */
+		keep = _mm_and_si128(_mm_cmpeq_epi32(_mm_srli_epi32(spix, 24), zero), amask);
+		_mm_storeu_si128((__m128i *)&dest[x], _mm_or_si128(_mm_and_si128(lo, rgbmask), _mm_and_si128(dpix, keep)));
+	}
+#elif defined(RENDERSW_NEON)
+	const uint16x8_t full = vdupq_n_u16(0x100);
+	const uint32x4_t rgbmask = vdupq_n_u32(0x00ffffff);
+	const uint32x4_t amask = vdupq_n_u32(0xff000000);
+
+	for ( ; x + 4 <= count; x += 4)
+	{
+		uint32x4_t spix = vld1q_u32(&src[x]);
+		uint32x4_t dpix = vld1q_u32(&dest[x]);
+		uint32x4_t ta = vshrq_n_u32(spix, 24);
+		uint8x16_t tabytes = vreinterpretq_u8_u32(vmulq_n_u32(ta, 0x01010101));
+		uint8x16_t sbytes = vreinterpretq_u8_u32(spix);
+		uint8x16_t dbytes = vreinterpretq_u8_u32(dpix);
+		uint16x8_t talo = vmovl_u8(vget_low_u8(tabytes));
+		uint16x8_t tahi = vmovl_u8(vget_high_u8(tabytes));
+		uint16x8_t lo, hi;
+		uint32x4_t result, keep;
+
+		/* (s * ta + d * (0x100 - ta)) >> 8 never exceeds 16 bits */
+		lo = vaddq_u16(vmulq_u16(vmovl_u8(vget_low_u8(sbytes)), talo), vmulq_u16(vmovl_u8(vget_low_u8(dbytes)), vsubq_u16(full, talo)));
+		hi = vaddq_u16(vmulq_u16(vmovl_u8(vget_high_u8(sbytes)), tahi), vmulq_u16(vmovl_u8(vget_high_u8(dbytes)), vsubq_u16(full, tahi)));
+		result = vreinterpretq_u32_u8(vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+
+		/* blended pixels get a zero top byte, skipped ones keep theirs */
+		keep = vandq_u32(vceqq_u32(ta, vdupq_n_u32(0)), amask);
+		vst1q_u32(&dest[x], vorrq_u32(vandq_u32(result, rgbmask), vandq_u32(dpix, keep)));
+	}
+#endif
+
+	span_argb32_blend_rgb888_c(dest + x, src + x, count - x);
+}
+
+
+/*-------------------------------------------------
+    span_benchmark - run one span helper and its
+    plain C form over the same random pixels;
+    returns the helper's name, or NULL past the
+    last one, the best of a few runs of each in
+    osd ticks, and whether the outputs matched
+-------------------------------------------------*/
+
+static const char *span_benchmark(int kernel, INT32 pixels, osd_ticks_t *scalar, osd_ticks_t *vector, int *exact)
+{
+	static const char *const names[] = { "xRGB32 to RGB565", "ARGB32 over xRGB32" };
+	osd_ticks_t *ticks[2] = { scalar, vector };
+	UINT32 *src, *dest[2];
+	UINT32 seed = 1;
+
+	if (kernel < 0 || kernel >= ARRAY_LENGTH(names))
+		return NULL;
+
+	src = global_alloc_array(UINT32, pixels);
+	dest[0] = global_alloc_array(UINT32, pixels);
+	dest[1] = global_alloc_array(UINT32, pixels);
+
+	/* a private generator; a third of the source pixels each are transparent, opaque and in between */
+	for (INT32 index = 0; index < pixels; index++)
+	{
+		seed = seed * 1103515245 + 12345;
+		src[index] = seed;
+		if ((seed >> 8) % 3 == 0)
+			src[index] &= 0x00ffffff;
+		else if ((seed >> 8) % 3 == 1)
+			src[index] |= 0xff000000;
+		seed = seed * 1103515245 + 12345;
+		dest[0][index] = dest[1][index] = seed;
+	}
+
+	/* the blend works in place, so both forms see the same sequence of destinations */
+	for (int path = 0; path < 2; path++)
+		for (int run = 0; run < 5; run++)
+		{
+			osd_ticks_t start = osd_ticks();
+			switch (kernel)
+			{
+				case 0:
+					if (path == 0) span_rgb32_to_rgb565_c((UINT16 *)dest[path], src, pixels);
+					else span_rgb32_to_rgb565((UINT16 *)dest[path], src, pixels);
+					break;
+				case 1:
+					if (path == 0) span_argb32_blend_rgb888_c(dest[path], src, pixels);
+					else span_argb32_blend_rgb888(dest[path], src, pixels);
+					break;
+			}
+			osd_ticks_t elapsed = osd_ticks() - start;
+			if (run == 0 || elapsed < *ticks[path])
+				*ticks[path] = elapsed;
+		}
+
+	*exact = (memcmp(dest[0], dest[1], pixels * sizeof(dest[0][0])) == 0);
+	global_free(dest[1]);
+	global_free(dest[0]);
+	global_free(src);
+	return names[kernel];
+}
+
+
 #endif
 
 
@@ -503,6 +795,222 @@ INLINE UINT32 get_texel_argb32_bilinear(const render_texinfo *texture, INT32 cur
 #undef GET_TEXEL
 #define GET_TEXEL(type)				get_texel_##type##_##nearest
 
+/* destination formats with vector span conversions */
+#ifndef VARIABLE_SHIFT
+#if (SRCSHIFT_R == 3) && (SRCSHIFT_G == 2) && (SRCSHIFT_B == 3) && (DSTSHIFT_R == 11) && (DSTSHIFT_G == 5) && (DSTSHIFT_B == 0)
+#define DEST_IS_RGB565
+#elif (SRCSHIFT_R == 0) && (SRCSHIFT_G == 0) && (SRCSHIFT_B == 0) && (DSTSHIFT_R == 16) && (DSTSHIFT_G == 8) && (DSTSHIFT_B == 0)
+#define DEST_IS_RGB888
+#endif
+#endif
+
+
+
+/***************************************************************************
+    SPAN RASTERIZERS
+***************************************************************************/
+
+/*-------------------------------------------------
+    convert_span32 - convert a span of 32-bit
+    source pixels to the destination format
+-------------------------------------------------*/
+
+INLINE void FUNC_PREFIX(convert_span32)(PIXEL_TYPE *dest, const UINT32 *src, INT32 count)
+{
+#if defined(DEST_IS_RGB565)
+	span_rgb32_to_rgb565((UINT16 *)dest, src, count);
+#elif defined(DEST_IS_RGB888)
+	if (count > 0)
+		memcpy(dest, src, count * sizeof(*dest));
+#else
+	for (INT32 x = 0; x < count; x++)
+		dest[x] = SOURCE32_TO_DEST(src[x]);
+#endif
+}
+
+
+/*-------------------------------------------------
+    convert_span15 - convert a span of 15-bit
+    source pixels to the destination format
+-------------------------------------------------*/
+
+INLINE void FUNC_PREFIX(convert_span15)(PIXEL_TYPE *dest, const UINT16 *src, INT32 count)
+{
+#if defined(DEST_IS_RGB565)
+	span_rgb15_to_rgb565_c((UINT16 *)dest, src, count);
+#elif defined(DEST_IS_RGB888)
+	span_rgb15_to_rgb888_c((UINT32 *)dest, src, count);
+#else
+	for (INT32 x = 0; x < count; x++)
+		dest[x] = SOURCE15_TO_DEST(src[x]);
+#endif
+}
+
+
+/*-------------------------------------------------
+    draw_span_palette16 - draw an unrotated span
+    of a 16bpp palettized texture with no
+    coloring or alpha
+-------------------------------------------------*/
+
+static void FUNC_PREFIX(draw_span_palette16)(const render_texinfo *texture, PIXEL_TYPE *dest, INT32 curu, INT32 curv, INT32 dudx, INT32 count)
+{
+	const UINT16 *texrow = (const UINT16 *)texture->base + (curv >> 16) * texture->rowpixels;
+	const rgb_t *palette = texture->palette;
+#if !defined(DEST_IS_RGB888)
+	UINT32 buffer[SPAN_CHUNK];
+#endif
+
+	while (count > 0)
+	{
+		INT32 chunk = MIN(count, SPAN_CHUNK);
+#if defined(DEST_IS_RGB888)
+		UINT32 *fetch = (UINT32 *)dest;
+#else
+		UINT32 *fetch = buffer;
+#endif
+
+		/* look up the palette a chunk at a time */
+		if (dudx == 0x10000)
+		{
+			const UINT16 *src = texrow + (curu >> 16);
+			for (INT32 x = 0; x < chunk; x++)
+				fetch[x] = palette[src[x]];
+			curu += chunk << 16;
+		}
+		else
+		{
+			for (INT32 x = 0; x < chunk; x++)
+			{
+				fetch[x] = palette[texrow[curu >> 16]];
+				curu += dudx;
+			}
+		}
+
+#if !defined(DEST_IS_RGB888)
+		FUNC_PREFIX(convert_span32)(dest, buffer, chunk);
+#endif
+		dest += chunk;
+		count -= chunk;
+	}
+}
+
+
+/*-------------------------------------------------
+    draw_span_rgb15 - draw an unrotated span of
+    a 15bpp RGB texture with no lookup, coloring
+    or alpha
+-------------------------------------------------*/
+
+static void FUNC_PREFIX(draw_span_rgb15)(const render_texinfo *texture, PIXEL_TYPE *dest, INT32 curu, INT32 curv, INT32 dudx, INT32 count)
+{
+	const UINT16 *texrow = (const UINT16 *)texture->base + (curv >> 16) * texture->rowpixels;
+	UINT16 buffer[SPAN_CHUNK];
+
+	/* unscaled spans convert straight from the texture */
+	if (dudx == 0x10000)
+	{
+		FUNC_PREFIX(convert_span15)(dest, texrow + (curu >> 16), count);
+		return;
+	}
+
+	while (count > 0)
+	{
+		INT32 chunk = MIN(count, SPAN_CHUNK);
+
+		for (INT32 x = 0; x < chunk; x++)
+		{
+			buffer[x] = texrow[curu >> 16];
+			curu += dudx;
+		}
+		FUNC_PREFIX(convert_span15)(dest, buffer, chunk);
+		dest += chunk;
+		count -= chunk;
+	}
+}
+
+
+/*-------------------------------------------------
+    draw_span_rgb32 - draw an unrotated span of
+    a 32bpp RGB texture with no lookup, coloring
+    or alpha
+-------------------------------------------------*/
+
+static void FUNC_PREFIX(draw_span_rgb32)(const render_texinfo *texture, PIXEL_TYPE *dest, INT32 curu, INT32 curv, INT32 dudx, INT32 count)
+{
+	const UINT32 *texrow = (const UINT32 *)texture->base + (curv >> 16) * texture->rowpixels;
+	UINT32 buffer[SPAN_CHUNK];
+
+	/* unscaled spans convert straight from the texture */
+	if (dudx == 0x10000)
+	{
+		FUNC_PREFIX(convert_span32)(dest, texrow + (curu >> 16), count);
+		return;
+	}
+
+#if defined(DEST_IS_RGB888)
+	/* no conversion needed, so scaled spans are a plain gather */
+	for (INT32 x = 0; x < count; x++)
+	{
+		dest[x] = texrow[curu >> 16];
+		curu += dudx;
+	}
+	return;
+#endif
+
+	while (count > 0)
+	{
+		INT32 chunk = MIN(count, SPAN_CHUNK);
+
+		for (INT32 x = 0; x < chunk; x++)
+		{
+			buffer[x] = texrow[curu >> 16];
+			curu += dudx;
+		}
+		FUNC_PREFIX(convert_span32)(dest, buffer, chunk);
+		dest += chunk;
+		count -= chunk;
+	}
+}
+
+
+#if defined(DEST_IS_RGB888) && !NO_DEST_READ
+/*-------------------------------------------------
+    draw_span_argb32_alpha - alpha blend an
+    unrotated span of a 32bpp ARGB texture with
+    no lookup or coloring
+-------------------------------------------------*/
+
+static void FUNC_PREFIX(draw_span_argb32_alpha)(const render_texinfo *texture, PIXEL_TYPE *dest, INT32 curu, INT32 curv, INT32 dudx, INT32 count)
+{
+	const UINT32 *texrow = (const UINT32 *)texture->base + (curv >> 16) * texture->rowpixels;
+	UINT32 buffer[SPAN_CHUNK];
+
+	/* unscaled spans blend straight from the texture */
+	if (dudx == 0x10000)
+	{
+		span_argb32_blend_rgb888((UINT32 *)dest, texrow + (curu >> 16), count);
+		return;
+	}
+
+	while (count > 0)
+	{
+		INT32 chunk = MIN(count, SPAN_CHUNK);
+
+		for (INT32 x = 0; x < chunk; x++)
+		{
+			buffer[x] = texrow[curu >> 16];
+			curu += dudx;
+		}
+		span_argb32_blend_rgb888((UINT32 *)dest, buffer, chunk);
+		dest += chunk;
+		count -= chunk;
+	}
+}
+#endif
+
+
+
 /***************************************************************************
     LINE RASTERIZERS
 ***************************************************************************/
@@ -529,10 +1037,11 @@ INLINE void FUNC_PREFIX(draw_aa_pixel)(void *dstdata, UINT32 pitch, int x, int y
 
 
 /*-------------------------------------------------
-    draw_line - draw a line or point
+    draw_line - draw a line or point, clipped
+    to rows miny through maxy-1
 -------------------------------------------------*/
 
-static void FUNC_PREFIX(draw_line)(const render_primitive *prim, void *dstdata, INT32 width, INT32 height, UINT32 pitch)
+static void FUNC_PREFIX(draw_line)(const render_primitive *prim, void *dstdata, INT32 width, INT32 miny, INT32 maxy, UINT32 pitch)
 {
 	INT32 dx, dy, sx, sy, cx, cy;
 
@@ -548,11 +1057,6 @@ static void FUNC_PREFIX(draw_line)(const render_primitive *prim, void *dstdata,
 
 	if (PRIMFLAG_GET_ANTIALIAS(prim->flags))
 	{
-		/* build up the cosine table if we haven't yet */
-		if (cosine_table[0] == 0)
-			for (int entry = 2048; entry >= 0; entry--)
-				cosine_table[entry] = (int)((double)(1.0 / cos(atan((double)(entry) / 2048.0))) * 0x10000000 + 0.5);
-
 		INT32 beam = prim->width * 65536.0f;
 		if (beam < 0x00010000)
 			beam = 0x00010000;
@@ -579,7 +1083,7 @@ static void FUNC_PREFIX(draw_line)(const render_primitive *prim, void *dstdata,
 				{
 					dx = bwidth;		/* init diameter of beam */
 					dy = y1 >> 16;
-					if (dy >= 0 && dy < height)
+					if (dy >= miny && dy < maxy)
 						FUNC_PREFIX(draw_aa_pixel)(dstdata, pitch, x1, dy, Tinten(0xff & (~y1 >> 8), col));
 					dy++;
 					dx -= 0x10000 - (0xffff & y1);	/* take off amount plotted */
@@ -587,11 +1091,11 @@ static void FUNC_PREFIX(draw_line)(const render_primitive *prim, void *dstdata,
 					dx >>= 16;		/* adjust to pixel (solid) count */
 					while (dx--)		/* plot rest of pixels */
 					{
-						if (dy >= 0 && dy < height)
+						if (dy >= miny && dy < maxy)
 							FUNC_PREFIX(draw_aa_pixel)(dstdata, pitch, x1, dy, col);
 						dy++;
 					}
-					if (dy >= 0 && dy < height)
+					if (dy >= miny && dy < maxy)
 						FUNC_PREFIX(draw_aa_pixel)(dstdata, pitch, x1, dy, Tinten(a1, col));
 				}
 				if (x1 == xx) break;
@@ -611,7 +1115,7 @@ static void FUNC_PREFIX(draw_line)(const render_primitive *prim, void *dstdata,
 			x1 -= bwidth >> 1;			/* start back half the width */
 			for (;;)
 			{
-				if (y1 >= 0 && y1 < height)
+				if (y1 >= miny && y1 < maxy)
 				{
 					dy = bwidth;		/* calc diameter of beam */
 					dx = x1 >> 16;
@@ -656,8 +1160,8 @@ static void FUNC_PREFIX(draw_line)(const render_primitive *prim, void *dstdata,
 		{
 			for (;;)
 			{
-				if (x1 >= 0 && y1 >= 0)
-					if (x1 < width && y1 < height)
+				if (x1 >= 0 && y1 >= miny)
+					if (x1 < width && y1 < maxy)
 						FUNC_PREFIX(draw_aa_pixel)(dstdata, pitch, x1, y1, col);
 				if (x1 == x2)
 					break;
@@ -675,8 +1179,8 @@ static void FUNC_PREFIX(draw_line)(const render_primitive *prim, void *dstdata,
 		{
 			for (;;)
 			{
-				if (x1 >= 0 && y1 >= 0)
-					if (x1 < width && y1 < height)
+				if (x1 >= 0 && y1 >= miny)
+					if (x1 < width && y1 < maxy)
 						FUNC_PREFIX(draw_aa_pixel)(dstdata, pitch, x1, y1, col);
 
 				if (y1 == y2)
@@ -701,10 +1205,11 @@ static void FUNC_PREFIX(draw_line)(const render_primitive *prim, void *dstdata,
 ***************************************************************************/
 
 /*-------------------------------------------------
-    draw_rect - draw a solid rectangle
+    draw_rect - draw a solid rectangle, clipped
+    to rows miny through maxy-1
 -------------------------------------------------*/
 
-static void FUNC_PREFIX(draw_rect)(const render_primitive *prim, void *dstdata, INT32 width, INT32 height, UINT32 pitch)
+static void FUNC_PREFIX(draw_rect)(const render_primitive *prim, void *dstdata, INT32 width, INT32 height, INT32 miny, INT32 maxy, UINT32 pitch)
 {
 	render_bounds fpos = prim->bounds;
 
@@ -738,6 +1243,12 @@ static void FUNC_PREFIX(draw_rect)(const render_primitive *prim, void *dstdata,
 	else if (endy >= height)
 		endy = height;
 
+	/* clip to the band */
+	if (starty < miny)
+		starty = miny;
+	if (endy > maxy)
+		endy = maxy;
+
 	/* bail if nothing left */
 	if (fpos.x0 > fpos.x1 || fpos.y0 > fpos.y1)
 		return;
@@ -856,6 +1367,13 @@ static void FUNC_PREFIX(draw_quad_palette16_none)(const render_primitive *prim,
 				curu = setup->startu + setup->dudy * deviation;
 				curv = setup->startv + setup->dvdy * deviation;
 
+				/* unrotated rows go through the span path */
+				if (dvdx == 0)
+				{
+					FUNC_PREFIX(draw_span_palette16)(&prim->texture, dest, curu, curv, dudx, endx - setup->startx);
+					continue;
+				}
+
 				/* loop over cols */
 				for (INT32 x = setup->startx; x < endx; x++)
 				{
@@ -1295,8 +1813,12 @@ static void FUNC_PREFIX(draw_quad_rgb15)(const render_primitive *prim, void *dst
 				curu = setup->startu + (y - setup->starty) * setup->dudy;
 				curv = setup->startv + (y - setup->starty) * setup->dvdy;
 
+				/* no lookup case, unrotated */
+				if (palbase == NULL && dvdx == 0)
+					FUNC_PREFIX(draw_span_rgb15)(&prim->texture, dest, curu, curv, dudx, endx - setup->startx);
+
 				/* no lookup case */
-				if (palbase == NULL)
+				else if (palbase == NULL)
 				{
 					/* loop over cols */
 					for (INT32 x = setup->startx; x < endx; x++)
@@ -1482,8 +2004,12 @@ static void FUNC_PREFIX(draw_quad_rgb32)(const render_primitive *prim, void *dst
 				curu = setup->startu + setup->dudy * deviation;
 				curv = setup->startv + setup->dvdy * deviation;
 
+				/* no lookup case, unrotated */
+				if (palbase == NULL && dvdx == 0)
+					FUNC_PREFIX(draw_span_rgb32)(&prim->texture, dest, curu, curv, dudx, endx - setup->startx);
+
 				/* no lookup case */
-				if (palbase == NULL)
+				else if (palbase == NULL)
 				{
 					/* loop over cols */
 					for (INT32 x = setup->startx; x < endx; x++)
@@ -1806,6 +2332,12 @@ static void FUNC_PREFIX(draw_quad_argb32_alpha)(const render_primitive *prim, vo
 			curu = setup->startu + (y - setup->starty) * setup->dudy;
 			curv = setup->startv + (y - setup->starty) * setup->dvdy;
 
+#if defined(DEST_IS_RGB888) && !NO_DEST_READ
+			/* no lookup case, unrotated */
+			if (palbase == NULL && dvdx == 0)
+				FUNC_PREFIX(draw_span_argb32_alpha)(&prim->texture, dest, curu, curv, dudx, endx - setup->startx);
+			else
+#endif
 			/* no lookup case */
 			if (palbase == NULL)
 			{
@@ -2222,10 +2754,11 @@ static void FUNC_PREFIX(draw_quad_argb32_add)(const render_primitive *prim, void
 /*-------------------------------------------------
     setup_and_draw_textured_quad - perform setup
     and then dispatch to a texture-mode-specific
-    drawing routine
+    drawing routine, clipped to rows miny
+    through maxy-1
 -------------------------------------------------*/
 
-static void FUNC_PREFIX(setup_and_draw_textured_quad)(const render_primitive *prim, void *dstdata, INT32 width, INT32 height, UINT32 pitch)
+static void FUNC_PREFIX(setup_and_draw_textured_quad)(const render_primitive *prim, void *dstdata, INT32 width, INT32 height, INT32 miny, INT32 maxy, UINT32 pitch)
 {
 	assert(prim->bounds.x0 <= prim->bounds.x1);
 	assert(prim->bounds.y0 <= prim->bounds.y1);
@@ -2278,6 +2811,21 @@ static void FUNC_PREFIX(setup_and_draw_textured_quad)(const render_primitive *pr
 	setup.startu += (setup.dudx + setup.dudy) / 2;
 	setup.startv += (setup.dvdx + setup.dvdy) / 2;
 
+	/* clip to the band; the rasterizers step U/V from starty, so */
+	/* skipping rows here yields exactly the same texels */
+	if (setup.endy > maxy)
+		setup.endy = maxy;
+	if (setup.starty < miny)
+	{
+		if (setup.endy <= miny)
+			return;
+		setup.startu += (UINT32)setup.dudy * (UINT32)(miny - setup.starty);
+		setup.startv += (UINT32)setup.dvdy * (UINT32)(miny - setup.starty);
+		setup.starty = miny;
+	}
+	if (setup.starty >= setup.endy)
+		return;
+
 	/* render based on the texture coordinates */
 	switch (prim->flags & (PRIMFLAG_TEXFORMAT_MASK | PRIMFLAG_BLENDMODE_MASK))
 	{
@@ -2338,11 +2886,12 @@ static void FUNC_PREFIX(setup_and_draw_textured_quad)(const render_primitive *pr
 ***************************************************************************/
 
 /*-------------------------------------------------
-    draw_primitives - draw a series of primitives
-    using a software rasterizer
+    draw_primitives_band - draw a series of
+    primitives, touching only rows miny through
+    maxy-1 of the destination
 -------------------------------------------------*/
 
-static void FUNC_PREFIX(draw_primitives)(const render_primitive_list &primlist, void *dstdata, UINT32 width, UINT32 height, UINT32 pitch)
+static void FUNC_PREFIX(draw_primitives_band)(const render_primitive_list &primlist, void *dstdata, UINT32 width, UINT32 height, UINT32 pitch, INT32 miny, INT32 maxy)
 {
 	const render_primitive *prim;
 
@@ -2353,14 +2902,17 @@ static void FUNC_PREFIX(draw_primitives)(const render_primitive_list &primlist,
 		switch (prim->type)
 		{
 			case render_primitive::LINE:
-				FUNC_PREFIX(draw_line)(prim, dstdata, width, height, pitch);
+				FUNC_PREFIX(draw_line)(prim, dstdata, width, miny, maxy, pitch);
 				break;
 
 			case render_primitive::QUAD:
+				/* skip quads that can't touch this band */
+				if (round_nearest(prim->bounds.y1) <= miny || round_nearest(prim->bounds.y0) >= maxy)
+					break;
 				if (!prim->texture.base)
-					FUNC_PREFIX(draw_rect)(prim, dstdata, width, height, pitch);
+					FUNC_PREFIX(draw_rect)(prim, dstdata, width, height, miny, maxy, pitch);
 				else
-					FUNC_PREFIX(setup_and_draw_textured_quad)(prim, dstdata, width, height, pitch);
+					FUNC_PREFIX(setup_and_draw_textured_quad)(prim, dstdata, width, height, miny, maxy, pitch);
 				break;
 
 			default:
@@ -2370,6 +2922,191 @@ static void FUNC_PREFIX(draw_primitives)(const render_primitive_list &primlist,
 }
 
 
+/*-------------------------------------------------
+    draw_band_callback - work item callback
+    that draws a single band
+-------------------------------------------------*/
+
+static void *FUNC_PREFIX(draw_band_callback)(void *param, int threadid)
+{
+	render_band_data *band = (render_band_data *)param;
+
+	FUNC_PREFIX(draw_primitives_band)(*band->primlist, band->dstdata, band->width, band->height, band->pitch, band->miny, band->maxy);
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    draw_span_direct - convert one unscaled span
+    of a direct primitive's texture
+-------------------------------------------------*/
+
+INLINE void FUNC_PREFIX(draw_span_direct)(const render_primitive *prim, PIXEL_TYPE *dest, INT32 x, INT32 y, INT32 count)
+{
+	switch (PRIMFLAG_GET_TEXFORMAT(prim->flags))
+	{
+		case TEXFORMAT_PALETTE16:
+			FUNC_PREFIX(draw_span_palette16)(&prim->texture, dest, x << 16, y << 16, 0x10000, count);
+			break;
+
+		case TEXFORMAT_RGB15:
+			FUNC_PREFIX(draw_span_rgb15)(&prim->texture, dest, x << 16, y << 16, 0x10000, count);
+			break;
+
+		default:
+			FUNC_PREFIX(draw_span_rgb32)(&prim->texture, dest, x << 16, y << 16, 0x10000, count);
+			break;
+	}
+}
+
+
+/*-------------------------------------------------
+    draw_primitives_direct - if the list is just
+    one unrotated, uncolored screen texture that
+    covers the destination at an integer scale,
+    convert it straight from the screen bitmap;
+    returns FALSE, having drawn nothing, for any
+    other list
+-------------------------------------------------*/
+
+static int FUNC_PREFIX(draw_primitives_direct)(const render_primitive_list &primlist, void *dstdata, UINT32 width, UINT32 height, UINT32 pitch)
+{
+	const render_primitive *prim = primlist.first();
+
+	/* anything on top of the screen (UI, crosshairs, artwork) needs the rasterizer */
+	if (prim == NULL || prim->next() != NULL || prim->type != render_primitive::QUAD || prim->texture.base == NULL)
+		return FALSE;
+	if ((prim->flags & PRIMFLAG_TEXORIENT_MASK) != 0)
+		return FALSE;
+	if (!IS_OPAQUE(prim->color.a) || prim->color.r < 1.0f || prim->color.g < 1.0f || prim->color.b < 1.0f)
+		return FALSE;
+
+	/* only the formats whose spans are plain lookups or conversions */
+	switch (prim->flags & (PRIMFLAG_TEXFORMAT_MASK | PRIMFLAG_BLENDMODE_MASK))
+	{
+		case PRIMFLAG_TEXFORMAT(TEXFORMAT_PALETTE16) | PRIMFLAG_BLENDMODE(BLENDMODE_NONE):
+		case PRIMFLAG_TEXFORMAT(TEXFORMAT_PALETTE16) | PRIMFLAG_BLENDMODE(BLENDMODE_ALPHA):
+			break;
+
+		case PRIMFLAG_TEXFORMAT(TEXFORMAT_RGB15) | PRIMFLAG_BLENDMODE(BLENDMODE_NONE):
+		case PRIMFLAG_TEXFORMAT(TEXFORMAT_RGB15) | PRIMFLAG_BLENDMODE(BLENDMODE_ALPHA):
+		case PRIMFLAG_TEXFORMAT(TEXFORMAT_RGB32) | PRIMFLAG_BLENDMODE(BLENDMODE_NONE):
+		case PRIMFLAG_TEXFORMAT(TEXFORMAT_RGB32) | PRIMFLAG_BLENDMODE(BLENDMODE_ALPHA):
+			if (prim->texture.palette != NULL)
+				return FALSE;
+			break;
+
+		default:
+			return FALSE;
+	}
+
+	/* the quad must cover the whole destination with the whole texture */
+	if (prim->bounds.x0 != 0.0f || prim->bounds.y0 != 0.0f || prim->bounds.x1 != (float)width || prim->bounds.y1 != (float)height)
+		return FALSE;
+	if (prim->texcoords.tl.u != 0.0f || prim->texcoords.tl.v != 0.0f || prim->texcoords.tr.u != 1.0f || prim->texcoords.tr.v != 0.0f ||
+		prim->texcoords.bl.u != 0.0f || prim->texcoords.bl.v != 1.0f || prim->texcoords.br.u != 1.0f || prim->texcoords.br.v != 1.0f)
+		return FALSE;
+
+	INT32 texwidth = prim->texture.width;
+	INT32 texheight = prim->texture.height;
+	if (texwidth <= 0 || texheight <= 0 || width % texwidth != 0 || height % texheight != 0)
+		return FALSE;
+	INT32 xscale = width / texwidth;
+	INT32 yscale = height / texheight;
+
+	for (INT32 y = 0; y < texheight; y++)
+	{
+		PIXEL_TYPE *dest = (PIXEL_TYPE *)dstdata + y * yscale * pitch;
+
+		/* 1:1 rows convert in place; wider ones replicate each converted chunk */
+		if (xscale == 1)
+			FUNC_PREFIX(draw_span_direct)(prim, dest, 0, y, texwidth);
+		else
+		{
+			PIXEL_TYPE buffer[SPAN_CHUNK];
+			PIXEL_TYPE *out = dest;
+
+			for (INT32 x = 0; x < texwidth; x += SPAN_CHUNK)
+			{
+				INT32 chunk = MIN(texwidth - x, SPAN_CHUNK);
+
+				FUNC_PREFIX(draw_span_direct)(prim, buffer, x, y, chunk);
+				for (INT32 pix = 0; pix < chunk; pix++)
+					for (INT32 copy = 0; copy < xscale; copy++)
+						*out++ = buffer[pix];
+			}
+		}
+
+		/* taller ones repeat the row */
+		for (INT32 copy = 1; copy < yscale; copy++)
+			memcpy(dest + copy * pitch, dest, width * sizeof(PIXEL_TYPE));
+	}
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    draw_primitives - draw a series of primitives
+    using a software rasterizer
+-------------------------------------------------*/
+
+static void FUNC_PREFIX(draw_primitives)(const render_primitive_list &primlist, void *dstdata, UINT32 width, UINT32 height, UINT32 pitch)
+{
+	build_cosine_table();
+	FUNC_PREFIX(draw_primitives_band)(primlist, dstdata, width, height, pitch, 0, height);
+}
+
+
+/*-------------------------------------------------
+    draw_primitives_threaded - draw a series of
+    primitives by splitting the destination into
+    horizontal bands and rendering each band on
+    the given work queue; the output is identical
+    to draw_primitives
+-------------------------------------------------*/
+
+static void FUNC_PREFIX(draw_primitives_threaded)(const render_primitive_list &primlist, void *dstdata, UINT32 width, UINT32 height, UINT32 pitch, osd_work_queue *queue, int numbands)
+{
+	render_band_data band[MAX_RENDER_BANDS];
+	INT32 bandheight;
+	int bandnum;
+
+	/* clamp the band count so that each band has a useful amount of work */
+	if (numbands > MAX_RENDER_BANDS)
+		numbands = MAX_RENDER_BANDS;
+	if (numbands > (int)(height / MIN_BAND_HEIGHT))
+		numbands = height / MIN_BAND_HEIGHT;
+
+	/* fall back to a single pass if there's nothing to split */
+	if (queue == NULL || numbands <= 1)
+	{
+		FUNC_PREFIX(draw_primitives)(primlist, dstdata, width, height, pitch);
+		return;
+	}
+
+	/* the lazily-built tables must exist before the bands start */
+	build_cosine_table();
+
+	/* carve the destination into bands */
+	bandheight = (height + numbands - 1) / numbands;
+	for (bandnum = 0; bandnum < numbands; bandnum++)
+	{
+		band[bandnum].primlist = &primlist;
+		band[bandnum].dstdata = dstdata;
+		band[bandnum].width = width;
+		band[bandnum].height = height;
+		band[bandnum].pitch = pitch;
+		band[bandnum].miny = MIN(bandnum * bandheight, (INT32)height);
+		band[bandnum].maxy = MIN((bandnum + 1) * bandheight, (INT32)height);
+	}
+
+	/* queue them all and help out until every band is done */
+	osd_work_item_queue_multiple(queue, FUNC_PREFIX(draw_band_callback), numbands, band, sizeof(band[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+	while (!osd_work_queue_wait(queue, osd_ticks_per_second()))
+		;
+}
+
+
 
 /***************************************************************************
     MACRO UNDOING
@@ -2408,4 +3145,7 @@ static void FUNC_PREFIX(draw_primitives)(const render_primitive_list &primlist,
 
 #undef VARIABLE_SHIFT
 
+#undef DEST_IS_RGB565
+#undef DEST_IS_RGB888
+
 #undef COMMON_PART
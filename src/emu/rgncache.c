@@ -0,0 +1,355 @@
+/***************************************************************************
+
+    rgncache.c
+
+    On-disk cache of decrypted and converted ROM regions.
+
+    Decryption and data conversion done at startup only depend on the
+    ROMs, so their results are written to <game>.rgc the first time and
+    mapped read-only on later starts.  The cache is keyed by the driver,
+    the selected BIOS, the hashes computed while verifying every ROM, the
+    host layout and CACHE_VERSION, which must be bumped whenever a cached
+    step changes.  Without verified ROMs there is nothing to key it on,
+    so it is neither used nor written.
+
+***************************************************************************/
+
+#include "emu.h"
+#include "emuopts.h"
+#include <zlib.h>
+
+
+
+/***************************************************************************
+    CONSTANTS
+***************************************************************************/
+
+#define CACHE_VERSION		2
+#define CACHE_ALIGN			4096		/* blocks start on a page so they can be used in place */
+#define MAX_CACHE_ENTRIES	32
+
+static const char cache_magic[8] = { 'M', 'B', 'A', 'R', 'G', 'N', 'C', 0 };
+
+
+
+/***************************************************************************
+    TYPE DEFINITIONS
+***************************************************************************/
+
+typedef struct _cache_header cache_header;
+struct _cache_header
+{
+	char		magic[8];
+	UINT32		version;
+	UINT32		key;			/* CRC of everything the cached data depends on */
+	UINT64		directory;		/* offset of the directory; 0 until the file is complete */
+	UINT32		entries;		/* number of directory entries */
+	UINT32		reserved;
+};
+
+
+typedef struct _cache_entry cache_entry;
+struct _cache_entry
+{
+	char		name[48];		/* "region.step", or a name of the caller's choosing */
+	UINT64		offset;			/* offset of the data in the file */
+	UINT32		length;			/* length of the data */
+	UINT32		reserved;
+};
+
+
+
+/***************************************************************************
+    GLOBAL VARIABLES
+***************************************************************************/
+
+static int cache_enabled;
+static UINT32 cache_key;
+
+/* the cache found at startup */
+static const UINT8 *cache_base;
+static UINT64 cache_length;
+static const cache_entry *cache_directory;
+static UINT32 cache_entries;
+
+/* the cache being built when none was found */
+static mame_file *cache_file;
+static UINT64 cache_offset;
+static cache_entry cache_pending[MAX_CACHE_ENTRIES];
+static UINT32 cache_pending_count;
+
+
+
+/***************************************************************************
+    FUNCTION PROTOTYPES
+***************************************************************************/
+
+static void region_cache_exit(running_machine &machine);
+
+
+
+/***************************************************************************
+    INITIALIZATION
+***************************************************************************/
+
+/*-------------------------------------------------
+    compute_key - hash everything the cached data
+    depends on; returns FALSE if the ROMs that
+    were loaded weren't verified
+-------------------------------------------------*/
+
+static int compute_key(running_machine *machine, UINT32 *key)
+{
+	static const UINT32 host[] = { CACHE_VERSION, sizeof(void *), 0x01020304 };
+	const char *bios = options_get_string(machine->options(), OPTION_BIOS);
+	UINT32 romkey;
+
+	if (!rom_load_verified_key(machine, &romkey))
+		return FALSE;
+
+	*key = crc32(0, (const Bytef *)host, sizeof(host));
+	*key = crc32(*key, (const Bytef *)machine->gamedrv->name, strlen(machine->gamedrv->name));
+	if (bios != NULL)
+		*key = crc32(*key, (const Bytef *)bios, strlen(bios));
+	*key = crc32(*key, (const Bytef *)&romkey, sizeof(romkey));
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    validate_cache - check that a mapped cache is
+    complete, current and self-consistent
+-------------------------------------------------*/
+
+static int validate_cache(const UINT8 *base, UINT64 length)
+{
+	const cache_header *header = (const cache_header *)base;
+
+	if (length < sizeof(*header) || memcmp(header->magic, cache_magic, sizeof(cache_magic)) != 0)
+		return FALSE;
+	if (header->version != CACHE_VERSION || header->key != cache_key || header->directory == 0)
+		return FALSE;
+	if (header->entries > MAX_CACHE_ENTRIES || header->directory > length || length - header->directory < header->entries * sizeof(cache_entry))
+		return FALSE;
+
+	const cache_entry *directory = (const cache_entry *)(base + header->directory);
+	for (UINT32 entry = 0; entry < header->entries; entry++)
+		if (directory[entry].offset > length || length - directory[entry].offset < directory[entry].length)
+			return FALSE;
+
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    release_cache - drop the mapped cache and any
+    cache left unfinished
+-------------------------------------------------*/
+
+static void release_cache(void)
+{
+	if (cache_base != NULL)
+		osd_unmap_file(cache_base, cache_length);
+	cache_base = NULL;
+	cache_directory = NULL;
+	cache_entries = 0;
+
+	if (cache_file != NULL)
+		mame_fclose(cache_file);
+	cache_file = NULL;
+	cache_pending_count = 0;
+}
+
+
+/*-------------------------------------------------
+    region_cache_init - map the cache of this game
+    if there is a valid one
+-------------------------------------------------*/
+
+void region_cache_init(running_machine *machine)
+{
+	astring filename(machine->basename(), ".rgc");
+	mame_file *file;
+	UINT64 length;
+
+	/* a previous machine may not have gone through its exit */
+	release_cache();
+
+	cache_enabled = options_get_bool(machine->options(), OPTION_REGION_CACHE) && options_get_string(machine->options(), OPTION_RGNCACHE_DIRECTORY)[0] != 0;
+	if (cache_enabled)
+		cache_enabled = compute_key(machine, &cache_key);
+	if (!cache_enabled)
+		return;
+
+	machine->add_notifier(MACHINE_NOTIFY_EXIT, region_cache_exit);
+
+	if (mame_fopen(SEARCHPATH_RGNCACHE, filename, OPEN_FLAG_READ, &file) != FILERR_NONE)
+		return;
+	astring fullpath(mame_file_full_name(file));
+	mame_fclose(file);
+
+	const UINT8 *base = (const UINT8 *)osd_map_file(fullpath, &length);
+	if (base == NULL)
+		return;
+
+	/* a stale or broken cache gets rebuilt */
+	if (!validate_cache(base, length))
+	{
+		mame_printf_verbose("Region cache %s is out of date\n", fullpath.cstr());
+		osd_unmap_file(base, length);
+		return;
+	}
+
+	cache_base = base;
+	cache_length = length;
+	cache_directory = (const cache_entry *)(base + ((const cache_header *)base)->directory);
+	cache_entries = ((const cache_header *)base)->entries;
+}
+
+
+/*-------------------------------------------------
+    region_cache_finish - complete the cache built
+    during startup
+-------------------------------------------------*/
+
+void region_cache_finish(running_machine *machine)
+{
+	cache_header header;
+
+	if (cache_file == NULL)
+		return;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, cache_magic, sizeof(header.magic));
+	header.version = CACHE_VERSION;
+	header.key = cache_key;
+	header.directory = cache_offset;
+	header.entries = cache_pending_count;
+
+	/* the header goes last, so that an interrupted write leaves an invalid file */
+	if (mame_fwrite(cache_file, cache_pending, cache_pending_count * sizeof(cache_entry)) == cache_pending_count * sizeof(cache_entry) &&
+		mame_fseek(cache_file, 0, SEEK_SET) == 0)
+		mame_fwrite(cache_file, &header, sizeof(header));
+
+	mame_fclose(cache_file);
+	cache_file = NULL;
+	cache_pending_count = 0;
+}
+
+
+/*-------------------------------------------------
+    region_cache_exit - release the cache
+-------------------------------------------------*/
+
+static void region_cache_exit(running_machine &machine)
+{
+	release_cache();
+}
+
+
+
+/***************************************************************************
+    CACHE ACCESS
+***************************************************************************/
+
+/*-------------------------------------------------
+    region_cache_find - return a cached block; the
+    data is read-only and lives until the machine
+    exits
+-------------------------------------------------*/
+
+const void *region_cache_find(running_machine *machine, const char *name, UINT32 length)
+{
+	for (UINT32 entry = 0; entry < cache_entries; entry++)
+		if (cache_directory[entry].length == length && strcmp(cache_directory[entry].name, name) == 0)
+			return cache_base + cache_directory[entry].offset;
+
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    region_cache_add - write a block to the cache
+    being built
+-------------------------------------------------*/
+
+void region_cache_add(running_machine *machine, const char *name, const void *data, UINT32 length)
+{
+	static const UINT8 padding[CACHE_ALIGN] = { 0 };
+	cache_entry *entry;
+
+	/* only build a cache when there was no valid one */
+	if (!cache_enabled || cache_base != NULL || cache_pending_count == MAX_CACHE_ENTRIES || strlen(name) >= sizeof(entry->name))
+		return;
+
+	if (cache_file == NULL)
+	{
+		astring filename(machine->basename(), ".rgc");
+		cache_header header;
+
+		if (mame_fopen(SEARCHPATH_RGNCACHE, filename, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS, &cache_file) != FILERR_NONE)
+		{
+			cache_enabled = FALSE;
+			return;
+		}
+
+		/* leave room for the header, written once everything else is */
+		memset(&header, 0, sizeof(header));
+		mame_fwrite(cache_file, &header, sizeof(header));
+		cache_offset = sizeof(header);
+	}
+
+	/* start the block on a page boundary */
+	UINT32 pad = (CACHE_ALIGN - (cache_offset & (CACHE_ALIGN - 1))) & (CACHE_ALIGN - 1);
+	if (mame_fwrite(cache_file, padding, pad) != pad || mame_fwrite(cache_file, data, length) != length)
+	{
+		/* out of space; give up on the cache and leave an incomplete file behind */
+		mame_fclose(cache_file);
+		cache_file = NULL;
+		cache_enabled = FALSE;
+		return;
+	}
+
+	entry = &cache_pending[cache_pending_count++];
+	memset(entry, 0, sizeof(*entry));
+	strcpy(entry->name, name);
+	entry->offset = cache_offset + pad;
+	entry->length = length;
+	cache_offset += pad + length;
+}
+
+
+/*-------------------------------------------------
+    region_cache_load_region - restore a region
+    as it was after the given step; returns TRUE
+    if it was cached and the step can be skipped
+-------------------------------------------------*/
+
+int region_cache_load_region(running_machine *machine, const char *region, const char *step)
+{
+	astring name(region, ".", step);
+	UINT8 *base = memory_region(machine, region);
+	UINT32 length = memory_region_length(machine, region);
+	const void *data;
+
+	if (base == NULL || (data = region_cache_find(machine, name, length)) == NULL)
+		return FALSE;
+
+	memcpy(base, data, length);
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    region_cache_save_region - cache a region as
+    it is after the given step
+-------------------------------------------------*/
+
+void region_cache_save_region(running_machine *machine, const char *region, const char *step)
+{
+	astring name(region, ".", step);
+	UINT8 *base = memory_region(machine, region);
+
+	if (base != NULL)
+		region_cache_add(machine, name, base, memory_region_length(machine, region));
+}
@@ -0,0 +1,34 @@
+/***************************************************************************
+
+    rgncache.h
+
+    On-disk cache of decrypted and converted ROM regions.
+
+***************************************************************************/
+
+#pragma once
+
+#ifndef __EMU_H__
+#error Dont include this file directly; include emu.h instead.
+#endif
+
+#ifndef __RGNCACHE_H__
+#define __RGNCACHE_H__
+
+
+/* startup; called once the ROMs are loaded, and once every device is started */
+void region_cache_init(running_machine *machine);
+void region_cache_finish(running_machine *machine);
+
+/* return a read-only cached block, or NULL if the cache has none of that name and length */
+const void *region_cache_find(running_machine *machine, const char *name, UINT32 length);
+
+/* add a block to the cache being built */
+void region_cache_add(running_machine *machine, const char *name, const void *data, UINT32 length);
+
+/* restore a region from the state cached after the given step, or cache its current state */
+int region_cache_load_region(running_machine *machine, const char *region, const char *step);
+void region_cache_save_region(running_machine *machine, const char *region, const char *step);
+
+
+#endif	/* __RGNCACHE_H__ */
@@ -16,18 +16,23 @@
 #include "harddisk.h"
 #include "config.h"
 #include "ui.h"
+#include <zlib.h>
 
 
 #define LOG_LOAD	0
 #define LOG(x)		do { if (LOG_LOAD) debugload x; } while(0)
 
 extern bool verify_rom_hash;
+extern bool verify_rom_hash_full;
 
 /***************************************************************************
     CONSTANTS
 ***************************************************************************/
 
 #define TEMPBUFFER_MAX_SIZE		(1024 * 1024 * 1024)
+#define MAX_ROM_JOBS			8					/* ROMs read at once; matches the ZIP cache size */
+#define ROM_STREAM_CHUNK		(256 * 1024)		/* piece size ROMs are decompressed in */
+#define ROM_HASH_CACHE			"romhash.txt"		/* hashes of ROMs that had to be read to verify them */
 
 
 
@@ -48,6 +53,49 @@ struct _open_chd
 
 
 typedef struct _romload_private rom_load_data;
+typedef struct _rom_load_job rom_load_job;
+typedef struct _rom_hash_entry rom_hash_entry;
+
+
+struct _rom_hash_entry
+{
+	rom_hash_entry *next;			/* pointer to next in the list */
+	astring			container;		/* file on disk the ROM was read from */
+	astring			member;			/* name of the ROM within the container */
+	UINT64			size;			/* size of the container when hashed */
+	UINT64			modified;		/* modification time of the container when hashed */
+	char			hash[HASH_BUF_SIZE];	/* hash of the ROM */
+};
+
+
+struct _rom_load_job
+{
+	rom_load_data *	romdata;		/* load we belong to */
+	mame_file *		file;			/* file being read; closed when the job finishes */
+	const rom_entry *baserom;		/* the ROM_LOAD entry */
+	rom_entry *		entries;		/* the entries read from the file, with flags inherited */
+	int				numentries;		/* number of entries */
+	UINT32			explength;		/* expected length of the file */
+	UINT8 *			regionbase;		/* base of the region being loaded */
+	int				direct;			/* TRUE if the file is read straight into the region */
+	osd_work_item *	item;			/* work item, if queued */
+
+	/* streaming state */
+	int				curentry;		/* entry being filled */
+	UINT32			entryleft;		/* bytes left for it */
+	UINT8 *			dest;			/* where the next byte or group goes */
+	int				groupbyte;		/* byte within the current group */
+
+	/* results */
+	UINT32			hashfunctions;	/* hash functions to compute while reading, or 0 */
+	hash_state		hash;			/* hash being computed */
+	char			acthash[HASH_BUF_SIZE];	/* resulting hash */
+	file_error		filerr;			/* result of the read */
+
+	UINT8			buffer[ROM_STREAM_CHUNK];	/* decompression buffer */
+};
+
+
 struct _romload_private
 {
 	running_machine		*machine;		/* machine object where needed */
@@ -67,6 +115,15 @@ struct _romload_private
 
 	region_info		*region;		/* info about current region */
 
+	osd_work_queue	*queue;			/* queue for reading ROMs in parallel */
+	rom_load_job	*jobs[MAX_ROM_JOBS];	/* ROMs being read, oldest first */
+	int				numjobs;		/* number of them */
+
+	rom_hash_entry	*hashcache;		/* hashes of ROMs computed on earlier runs */
+	int				hashcachedirty;	/* TRUE if hashes were added since */
+	UINT32			hashkey;		/* CRC of the hashes of every verified ROM */
+	int				romsverified;	/* number of ROMs that went through verification */
+
 	astring				errorstring;	/* error string */
 };
 
@@ -135,6 +192,172 @@ void set_disk_handle(running_machine *machine, const char *region, mame_file *fi
 
 
 
+/***************************************************************************
+    ROM HASH CACHE
+***************************************************************************/
+
+/*-------------------------------------------------
+    load_hash_cache - read the hashes computed
+    on earlier runs
+-------------------------------------------------*/
+
+static void load_hash_cache(rom_load_data *romdata)
+{
+	char buffer[2048];
+	mame_file *file;
+
+	/* only use a cache directory that was given to us */
+	if (options_get_string(romdata->machine->options(), OPTION_RGNCACHE_DIRECTORY)[0] == 0)
+		return;
+	if (mame_fopen(SEARCHPATH_RGNCACHE, ROM_HASH_CACHE, OPEN_FLAG_READ, &file) != FILERR_NONE)
+		return;
+
+	/* each line is: size, modified, hash, container and member, separated by tabs */
+	while (mame_fgets(buffer, ARRAY_LENGTH(buffer), file) != NULL)
+	{
+		char *field[5];
+		int fieldnum;
+
+		buffer[strcspn(buffer, "\r\n")] = 0;
+		field[0] = buffer;
+		for (fieldnum = 1; fieldnum < ARRAY_LENGTH(field); fieldnum++)
+		{
+			char *tab = strchr(field[fieldnum - 1], '\t');
+			if (tab == NULL)
+				break;
+			*tab = 0;
+			field[fieldnum] = tab + 1;
+		}
+		if (fieldnum < ARRAY_LENGTH(field) || strlen(field[2]) >= HASH_BUF_SIZE)
+			continue;
+
+		rom_hash_entry *entry = global_alloc(rom_hash_entry);
+		sscanf(field[0], "%" I64FMT "u", &entry->size);
+		sscanf(field[1], "%" I64FMT "u", &entry->modified);
+		strcpy(entry->hash, field[2]);
+		entry->container.cpy(field[3]);
+		entry->member.cpy(field[4]);
+		entry->next = romdata->hashcache;
+		romdata->hashcache = entry;
+	}
+	mame_fclose(file);
+}
+
+
+/*-------------------------------------------------
+    save_hash_cache - write out the hashes if any
+    were added and free them
+-------------------------------------------------*/
+
+static void save_hash_cache(rom_load_data *romdata)
+{
+	mame_file *file;
+
+	if (romdata->hashcachedirty && options_get_string(romdata->machine->options(), OPTION_RGNCACHE_DIRECTORY)[0] != 0 &&
+		mame_fopen(SEARCHPATH_RGNCACHE, ROM_HASH_CACHE, OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS, &file) == FILERR_NONE)
+	{
+		for (rom_hash_entry *entry = romdata->hashcache; entry != NULL; entry = entry->next)
+			mame_fprintf(file, "%" I64FMT "u\t%" I64FMT "u\t%s\t%s\t%s\n", entry->size, entry->modified, entry->hash, entry->container.cstr(), entry->member.cstr());
+		mame_fclose(file);
+	}
+
+	while (romdata->hashcache != NULL)
+	{
+		rom_hash_entry *entry = romdata->hashcache;
+		romdata->hashcache = entry->next;
+		global_free(entry);
+	}
+	romdata->hashcachedirty = FALSE;
+}
+
+
+/*-------------------------------------------------
+    find_hash_cache_entry - find the cached hash
+    of a ROM, current or not
+-------------------------------------------------*/
+
+static rom_hash_entry *find_hash_cache_entry(rom_load_data *romdata, mame_file *file)
+{
+	for (rom_hash_entry *entry = romdata->hashcache; entry != NULL; entry = entry->next)
+		if (entry->member == mame_file_member_name(file) && entry->container == mame_file_container_name(file))
+			return entry;
+
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    rom_hash_functions - return the hash functions
+    that have to be computed while reading a ROM
+    to verify it; when none are needed, the hash
+    to verify is copied to acthash
+-------------------------------------------------*/
+
+static UINT32 rom_hash_functions(rom_load_data *romdata, mame_file *file, const char *exphash, char *acthash)
+{
+	UINT32 functions = hash_data_used_functions(exphash);
+	const char *knownhash = mame_fhash(file, 0);
+
+	if (verify_rom_hash_full)
+		return functions;
+
+	/* a matching CRC from the ZIP directory is trusted as is */
+	if (hash_data_has_checksum(knownhash, HASH_CRC) && hash_data_has_checksum(exphash, HASH_CRC) && hash_data_is_equal(exphash, knownhash, HASH_CRC))
+	{
+		hash_data_copy(acthash, knownhash);
+		return 0;
+	}
+
+	/* otherwise use the hash from an earlier run if the container hasn't changed since */
+	rom_hash_entry *entry = find_hash_cache_entry(romdata, file);
+	if (entry != NULL && (hash_data_used_functions(entry->hash) & functions) == functions)
+	{
+		osd_directory_entry *info = osd_stat(mame_file_container_name(file));
+		int current = (info != NULL && info->size == entry->size && (UINT64)info->last_modified == entry->modified);
+
+		if (info != NULL)
+			osd_free(info);
+		if (current)
+		{
+			hash_data_copy(acthash, entry->hash);
+			return 0;
+		}
+	}
+	return functions;
+}
+
+
+/*-------------------------------------------------
+    remember_rom_hash - cache the hash of a ROM
+    that had to be read to verify it
+-------------------------------------------------*/
+
+static void remember_rom_hash(rom_load_data *romdata, mame_file *file, const char *hash)
+{
+	osd_directory_entry *info;
+	rom_hash_entry *entry;
+
+	if (verify_rom_hash_full || (info = osd_stat(mame_file_container_name(file))) == NULL)
+		return;
+
+	entry = find_hash_cache_entry(romdata, file);
+	if (entry == NULL)
+	{
+		entry = global_alloc(rom_hash_entry);
+		entry->container.cpy(mame_file_container_name(file));
+		entry->member.cpy(mame_file_member_name(file));
+		entry->next = romdata->hashcache;
+		romdata->hashcache = entry;
+	}
+	entry->size = info->size;
+	entry->modified = info->last_modified;
+	hash_data_copy(entry->hash, hash);
+	romdata->hashcachedirty = TRUE;
+	osd_free(info);
+}
+
+
+
 /***************************************************************************
     ROM LOADING
 ***************************************************************************/
@@ -465,18 +688,17 @@ static void dump_wrong_and_correct_checksums(rom_load_data *romdata, const char
     and hash signatures of a file
 -------------------------------------------------*/
 
-static void verify_length_and_hash(rom_load_data *romdata, const char *name, UINT32 explength, const char *hash)
+static void verify_length_and_hash(rom_load_data *romdata, const char *name, UINT32 explength, const char *hash, UINT32 actlength, const char *acthash)
 {
-	UINT32 actlength;
-	const char* acthash;
-
-	/* we've already complained if there is no file */
-	if (romdata->file == NULL)
-		return;
+	UINT8 crc[4];
 
-	/* get the length and CRC from the file */
-	actlength = mame_fsize(romdata->file);
-	acthash = mame_fhash(romdata->file, hash_data_used_functions(hash));
+	/* fold what was actually read into the key for data derived from the ROMs */
+	if (hash_data_extract_binary_checksum(acthash, HASH_CRC, crc))
+		romdata->hashkey = crc32(romdata->hashkey, crc, sizeof(crc));
+	else
+		romdata->hashkey = crc32(romdata->hashkey, (const Bytef *)acthash, strlen(acthash));
+	romdata->hashkey = crc32(romdata->hashkey, (const Bytef *)&actlength, sizeof(actlength));
+	romdata->romsverified++;
 
 	/* verify length */
 	if (explength != actlength)
@@ -634,9 +856,9 @@ static int open_rom_file(rom_load_data *romdata, const char *regiontag, const ro
 		{
 			astring fname(drv->name, PATH_SEPARATOR, ROM_GETNAME(romp));
 			if (has_crc)
-				filerr = mame_fopen_crc(SEARCHPATH_ROM, fname, crc, OPEN_FLAG_READ, &romdata->file);
+				filerr = mame_fopen_crc(SEARCHPATH_ROM, fname, crc, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD, &romdata->file);
 			else
-				filerr = mame_fopen(SEARCHPATH_ROM, fname, OPEN_FLAG_READ, &romdata->file);
+				filerr = mame_fopen(SEARCHPATH_ROM, fname, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD, &romdata->file);
 		}
 
 	/* if the region is load by name, load the ROM from there */
@@ -644,9 +866,9 @@ static int open_rom_file(rom_load_data *romdata, const char *regiontag, const ro
 	{
 		astring fname(regiontag, PATH_SEPARATOR, ROM_GETNAME(romp));
 		if (has_crc)
-			filerr = mame_fopen_crc(SEARCHPATH_ROM, fname, crc, OPEN_FLAG_READ, &romdata->file);
+			filerr = mame_fopen_crc(SEARCHPATH_ROM, fname, crc, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD, &romdata->file);
 		else
-			filerr = mame_fopen(SEARCHPATH_ROM, fname, OPEN_FLAG_READ, &romdata->file);
+			filerr = mame_fopen(SEARCHPATH_ROM, fname, OPEN_FLAG_READ | OPEN_FLAG_NO_PRELOAD, &romdata->file);
 	}
 
 	/* update counters */
@@ -678,25 +900,16 @@ static int rom_fread(rom_load_data *romdata, UINT8 *buffer, int length)
 
 
 /*-------------------------------------------------
-    read_rom_data - read ROM data for a single
-    entry
+    validate_rom_entry - make sure a ROM entry
+    fits its region
 -------------------------------------------------*/
 
-static int read_rom_data(rom_load_data *romdata, const rom_entry *romp)
+static void validate_rom_entry(rom_load_data *romdata, const rom_entry *romp)
 {
-	int datashift = ROM_GETBITSHIFT(romp);
-	int datamask = ((1 << ROM_GETBITWIDTH(romp)) - 1) << datashift;
 	int numbytes = ROM_GETLENGTH(romp);
 	int groupsize = ROM_GETGROUPSIZE(romp);
 	int skip = ROM_GETSKIPCOUNT(romp);
-	int reversed = ROM_ISREVERSED(romp);
 	int numgroups = (numbytes + groupsize - 1) / groupsize;
-	UINT8 *base = romdata->region->base() + ROM_GETOFFSET(romp);
-	UINT32 tempbufsize;
-	UINT8 *tempbuf;
-	int i;
-
-	LOG(("Loading ROM data: offs=%X len=%X mask=%02X group=%d skip=%d reverse=%d\n", ROM_GETOFFSET(romp), numbytes, datamask, groupsize, skip, reversed));
 
 	/* make sure the length was an even multiple of the group size */
 	if (numbytes % groupsize != 0)
@@ -709,6 +922,30 @@ static int read_rom_data(rom_load_data *romdata, const rom_entry *romp)
 	/* make sure the length was valid */
 	if (numbytes == 0)
 		fatalerror("Error in RomModule definition: %s has an invalid length\n", ROM_GETNAME(romp));
+}
+
+
+/*-------------------------------------------------
+    read_rom_data - read ROM data for a single
+    entry
+-------------------------------------------------*/
+
+static int read_rom_data(rom_load_data *romdata, const rom_entry *romp)
+{
+	int datashift = ROM_GETBITSHIFT(romp);
+	int datamask = ((1 << ROM_GETBITWIDTH(romp)) - 1) << datashift;
+	int numbytes = ROM_GETLENGTH(romp);
+	int groupsize = ROM_GETGROUPSIZE(romp);
+	int skip = ROM_GETSKIPCOUNT(romp);
+	int reversed = ROM_ISREVERSED(romp);
+	UINT8 *base = romdata->region->base() + ROM_GETOFFSET(romp);
+	UINT32 tempbufsize;
+	UINT8 *tempbuf;
+	int i;
+
+	LOG(("Loading ROM data: offs=%X len=%X mask=%02X group=%d skip=%d reverse=%d\n", ROM_GETOFFSET(romp), numbytes, datamask, groupsize, skip, reversed));
+
+	validate_rom_entry(romdata, romp);
 
 	/* special case for simple loads */
 	if (datamask == 0xff && (groupsize == 1 || !reversed) && skip == 0)
@@ -853,6 +1090,292 @@ static void copy_rom_data(rom_load_data *romdata, const rom_entry *romp)
 }
 
 
+/*-------------------------------------------------
+    is_simple_load - TRUE if an entry's data
+    goes to the region unchanged and contiguous
+-------------------------------------------------*/
+
+static int is_simple_load(const rom_entry *romp)
+{
+	return (ROM_GETBITWIDTH(romp) == 8 && (ROM_GETGROUPSIZE(romp) == 1 || !ROM_ISREVERSED(romp)) && ROM_GETSKIPCOUNT(romp) == 0);
+}
+
+
+/*-------------------------------------------------
+    entries_may_overlap - TRUE if two entries
+    might write the same bytes
+-------------------------------------------------*/
+
+static int entries_may_overlap(const rom_entry *a, const rom_entry *b)
+{
+	UINT32 astep = ROM_GETGROUPSIZE(a) + ROM_GETSKIPCOUNT(a);
+	UINT32 bstep = ROM_GETGROUPSIZE(b) + ROM_GETSKIPCOUNT(b);
+	UINT32 aend = ROM_GETOFFSET(a) + (ROM_GETLENGTH(a) / ROM_GETGROUPSIZE(a)) * astep;
+	UINT32 bend = ROM_GETOFFSET(b) + (ROM_GETLENGTH(b) / ROM_GETGROUPSIZE(b)) * bstep;
+
+	/* ignored data is never written */
+	if (ROMENTRY_ISIGNORE(a) || ROMENTRY_ISIGNORE(b))
+		return FALSE;
+
+	/* disjoint ranges can't collide */
+	if (aend <= ROM_GETOFFSET(b) || bend <= ROM_GETOFFSET(a))
+		return FALSE;
+
+	/* interleaved with the same stride, they collide only if they share a byte lane */
+	if (astep != bstep)
+		return TRUE;
+	for (int i = 0; i < ROM_GETGROUPSIZE(a); i++)
+		for (int j = 0; j < ROM_GETGROUPSIZE(b); j++)
+			if ((ROM_GETOFFSET(a) + i) % astep == (ROM_GETOFFSET(b) + j) % bstep)
+				return TRUE;
+	return FALSE;
+}
+
+
+/*-------------------------------------------------
+    next_job_entry - move a job on to the next
+    entry read from its file
+-------------------------------------------------*/
+
+static int next_job_entry(rom_load_job *job)
+{
+	if (job->curentry + 1 >= job->numentries)
+		return FALSE;
+
+	job->curentry++;
+	job->entryleft = ROM_GETLENGTH(&job->entries[job->curentry]);
+	job->dest = job->regionbase + ROM_GETOFFSET(&job->entries[job->curentry]);
+	job->groupbyte = 0;
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    write_job_data - store data read for the
+    current entry of a job, de-interleaving it
+    the way read_rom_data does
+-------------------------------------------------*/
+
+static void write_job_data(rom_load_job *job, const UINT8 *data, UINT32 length)
+{
+	const rom_entry *romp = &job->entries[job->curentry];
+	int datashift = ROM_GETBITSHIFT(romp);
+	int datamask = ((1 << ROM_GETBITWIDTH(romp)) - 1) << datashift;
+	int groupsize = ROM_GETGROUPSIZE(romp);
+	int step = groupsize + ROM_GETSKIPCOUNT(romp);
+	int reversed = ROM_ISREVERSED(romp);
+	UINT8 *dest = job->dest;
+	int groupbyte = job->groupbyte;
+
+	/* ignored data is just skipped */
+	if (ROMENTRY_ISIGNORE(romp))
+		return;
+
+	/* simple loads are a copy, or nothing at all if the data was read in place */
+	if (is_simple_load(romp))
+	{
+		if (data != dest)
+			memcpy(dest, data, length);
+		job->dest = dest + length;
+		return;
+	}
+
+	while (length-- > 0)
+	{
+		int index = reversed ? (groupsize - 1 - groupbyte) : groupbyte;
+
+		if (datamask == 0xff)
+			dest[index] = *data++;
+		else
+			dest[index] = (dest[index] & ~datamask) | ((*data++ << datashift) & datamask);
+
+		if (++groupbyte == groupsize)
+		{
+			groupbyte = 0;
+			dest += step;
+		}
+	}
+
+	job->dest = dest;
+	job->groupbyte = groupbyte;
+}
+
+
+/*-------------------------------------------------
+    rom_job_data - receive a piece of a file
+    being read by a job
+-------------------------------------------------*/
+
+static void rom_job_data(void *param, const void *data, UINT32 length)
+{
+	rom_load_job *job = (rom_load_job *)param;
+	const UINT8 *src = (const UINT8 *)data;
+
+	/* the whole file is hashed, including anything past the last entry */
+	if (job->hashfunctions != 0)
+		hash_buffer(&job->hash, src, length);
+
+	while (length > 0)
+	{
+		UINT32 count;
+
+		if (job->entryleft == 0 && !next_job_entry(job))
+			return;
+
+		count = MIN(length, job->entryleft);
+		write_job_data(job, src, count);
+		src += count;
+		length -= count;
+		job->entryleft -= count;
+	}
+}
+
+
+/*-------------------------------------------------
+    rom_job_callback - read a file into its
+    region; runs on the work queue
+-------------------------------------------------*/
+
+static void *rom_job_callback(void *param, int threadid)
+{
+	rom_load_job *job = (rom_load_job *)param;
+
+	job->curentry = -1;
+	job->entryleft = 0;
+	if (job->hashfunctions != 0)
+		hash_begin(&job->hash, job->hashfunctions);
+
+	/* a plain load of a whole file is decompressed straight into the region */
+	if (job->direct)
+		job->filerr = mame_fstream(job->file, job->regionbase + ROM_GETOFFSET(&job->entries[0]), ROM_GETLENGTH(&job->entries[0]), rom_job_data, job);
+	else
+		job->filerr = mame_fstream(job->file, job->buffer, sizeof(job->buffer), rom_job_data, job);
+
+	if (job->hashfunctions != 0)
+		hash_end(&job->hash, job->acthash);
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    finish_rom_jobs - wait for the oldest jobs,
+    verify their files and close them until at
+    most the given number are left
+-------------------------------------------------*/
+
+static void finish_rom_jobs(rom_load_data *romdata, int keep)
+{
+	while (romdata->numjobs > keep)
+	{
+		rom_load_job *job = romdata->jobs[0];
+
+		if (job->item != NULL)
+		{
+			while (!osd_work_item_wait(job->item, osd_ticks_per_second()))
+				;
+			osd_work_item_release(job->item);
+		}
+
+		/* report a file that couldn't be read instead of verifying it */
+		if (job->filerr != FILERR_NONE)
+		{
+			romdata->errorstring.catprintf("%s COULD NOT BE READ\n", ROM_GETNAME(job->baserom));
+			romdata->warnings++;
+		}
+		else if (verify_rom_hash)
+		{
+			LOG(("Verifying length (%X) and checksums\n", job->explength));
+			verify_length_and_hash(romdata, ROM_GETNAME(job->baserom), job->explength, ROM_GETHASHDATA(job->baserom),
+				mame_fsize(job->file), job->acthash);
+			if (job->hashfunctions != 0)
+				remember_rom_hash(romdata, job->file, job->acthash);
+			LOG(("Verify finished\n"));
+		}
+
+		LOG(("Closing ROM file\n"));
+		mame_fclose(job->file);
+		auto_free(romdata->machine, job->entries);
+		auto_free(romdata->machine, job);
+
+		memmove(&romdata->jobs[0], &romdata->jobs[1], --romdata->numjobs * sizeof(romdata->jobs[0]));
+	}
+}
+
+
+/*-------------------------------------------------
+    queue_rom_job - start reading the open file
+    for a ROM_LOAD and its continues on the work
+    queue; returns the entry after them
+-------------------------------------------------*/
+
+static const rom_entry *queue_rom_job(rom_load_data *romdata, const rom_entry *romp, const rom_entry *end, UINT32 *lastflags)
+{
+	rom_load_job *job = auto_alloc_clear(romdata->machine, rom_load_job);
+	int entrynum, jobnum;
+
+	job->romdata = romdata;
+	job->file = romdata->file;
+	job->baserom = romp;
+	job->regionbase = romdata->region->base();
+	job->numentries = end - romp;
+	job->entries = auto_alloc_array(romdata->machine, rom_entry, job->numentries);
+	romdata->file = NULL;
+
+	/* apply flag inheritance up front and check that everything fits */
+	for (entrynum = 0; entrynum < job->numentries; entrynum++)
+	{
+		rom_entry *entry = &job->entries[entrynum];
+
+		*entry = romp[entrynum];
+		if (!ROM_INHERITSFLAGS(entry))
+			*lastflags = entry->_flags;
+		else
+			entry->_flags = (entry->_flags & ~ROM_INHERITEDFLAGS) | *lastflags;
+
+		job->explength += ROM_GETLENGTH(entry);
+		if (!ROMENTRY_ISIGNORE(entry))
+		{
+			LOG(("Loading ROM data: offs=%X len=%X group=%d skip=%d reverse=%d\n", ROM_GETOFFSET(entry), ROM_GETLENGTH(entry), ROM_GETGROUPSIZE(entry), ROM_GETSKIPCOUNT(entry), ROM_ISREVERSED(entry)));
+			validate_rom_entry(romdata, entry);
+		}
+	}
+
+	/* a file that exactly fills one simple entry needs no buffer */
+	job->direct = (job->numentries == 1 && !ROMENTRY_ISIGNORE(&job->entries[0]) && is_simple_load(&job->entries[0]) &&
+					mame_fsize(job->file) == ROM_GETLENGTH(&job->entries[0]));
+
+	if (verify_rom_hash)
+		job->hashfunctions = rom_hash_functions(romdata, job->file, ROM_GETHASHDATA(romp), job->acthash);
+
+	/* wait for earlier jobs that write the same bytes, so that the last one still wins */
+	for (jobnum = romdata->numjobs - 1; jobnum >= 0; jobnum--)
+	{
+		rom_load_job *other = romdata->jobs[jobnum];
+		int overlap = FALSE;
+
+		for (int i = 0; i < job->numentries && !overlap; i++)
+			for (int j = 0; j < other->numentries && !overlap; j++)
+				overlap = entries_may_overlap(&job->entries[i], &other->entries[j]);
+
+		if (overlap)
+		{
+			finish_rom_jobs(romdata, romdata->numjobs - jobnum - 1);
+			break;
+		}
+	}
+
+	/* make room, then queue it; without a queue, just read it now */
+	finish_rom_jobs(romdata, MAX_ROM_JOBS - 1);
+	romdata->jobs[romdata->numjobs++] = job;
+
+	job->item = (romdata->queue != NULL) ? osd_work_item_queue(romdata->queue, rom_job_callback, job, 0) : NULL;
+	if (job->item == NULL)
+		rom_job_callback(job, 0);
+
+	return end;
+}
+
+
 /*-------------------------------------------------
     process_rom_entries - process all ROM entries
     for a region
@@ -877,19 +1400,26 @@ static void process_rom_entries(rom_load_data *romdata, const char *regiontag, c
 		if (ROMENTRY_ISRELOAD(romp))
 			fatalerror("Error in RomModule definition: ROM_RELOAD not preceded by ROM_LOAD\n");
 
-		/* handle fills */
+		/* handle fills; files being read must land first */
 		if (ROMENTRY_ISFILL(romp))
+		{
+			finish_rom_jobs(romdata, 0);
 			fill_rom_data(romdata, romp++);
+		}
 
 		/* handle copies */
 		else if (ROMENTRY_ISCOPY(romp))
+		{
+			finish_rom_jobs(romdata, 0);
 			copy_rom_data(romdata, romp++);
+		}
 
 		/* handle files */
 		else if (ROMENTRY_ISFILE(romp))
 		{
 			int irrelevantbios = (ROM_GETBIOSFLAGS(romp) != 0 && ROM_GETBIOSFLAGS(romp) != romdata->system_bios);
 			const rom_entry *baserom = romp;
+			const rom_entry *groupend = romp + 1;
 			int explength = 0;
 
 			/* open the file if it is a non-BIOS or matches the current BIOS */
@@ -897,6 +1427,18 @@ static void process_rom_entries(rom_load_data *romdata, const char *regiontag, c
 			if (!irrelevantbios && !open_rom_file(romdata, regiontag, romp))
 				handle_missing_file(romdata, romp);
 
+			/* a file read only once is streamed into place on the work queue */
+			while (ROMENTRY_ISCONTINUE(groupend) || ROMENTRY_ISIGNORE(groupend))
+				groupend++;
+			if (romdata->file != NULL && !ROMENTRY_ISRELOAD(groupend))
+			{
+				romp = queue_rom_job(romdata, romp, groupend, &lastflags);
+				continue;
+			}
+
+			/* anything else is read here, in order */
+			finish_rom_jobs(romdata, 0);
+
 			/* loop until we run out of reloads */
 			do
 			{
@@ -921,10 +1463,21 @@ static void process_rom_entries(rom_load_data *romdata, const char *regiontag, c
 				while ( ROMENTRY_ISCONTINUE(romp) || ROMENTRY_ISIGNORE(romp) ) ;
 
 				/* if this was the first use of this file, verify the length and CRC */
-				if (baserom && verify_rom_hash)
+				/* (we've already complained if there is no file) */
+				if (baserom && verify_rom_hash && romdata->file != NULL)
 				{
+					char acthash[HASH_BUF_SIZE];
+					UINT32 functions = rom_hash_functions(romdata, romdata->file, ROM_GETHASHDATA(baserom), acthash);
+
+					if (functions != 0)
+					{
+						hash_data_copy(acthash, mame_fhash(romdata->file, functions));
+						remember_rom_hash(romdata, romdata->file, acthash);
+					}
+
 					LOG(("Verifying length (%X) and checksums\n", explength));
-					verify_length_and_hash(romdata, ROM_GETNAME(baserom), explength, ROM_GETHASHDATA(baserom));
+					verify_length_and_hash(romdata, ROM_GETNAME(baserom), explength, ROM_GETHASHDATA(baserom),
+						mame_fsize(romdata->file), acthash);
 					LOG(("Verify finished\n"));
 				}
 
@@ -949,6 +1502,9 @@ static void process_rom_entries(rom_load_data *romdata, const char *regiontag, c
 			romp++;	/* something else; skip */
 		}
 	}
+
+	/* the region must be complete before it is post-processed */
+	finish_rom_jobs(romdata, 0);
 }
 
 
@@ -1393,8 +1949,17 @@ void rom_init(running_machine *machine)
 	romdata->chd_list = NULL;
 	romdata->chd_list_tailptr = &machine->romload_data->chd_list;
 
-	/* process the ROM entries we were passed */
+	/* hashes computed before save reading ROMs whose CRC can't be trusted */
+	if (verify_rom_hash && !verify_rom_hash_full)
+		load_hash_cache(romdata);
+
+	/* process the ROM entries we were passed, reading files in parallel */
+	romdata->queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_IO | WORK_QUEUE_FLAG_MULTI);
 	process_region_list(romdata);
+	if (romdata->queue != NULL)
+		osd_work_queue_free(romdata->queue);
+	romdata->queue = NULL;
+	save_hash_cache(romdata);
 
 	/* display the results and exit */
 	display_rom_load_results(romdata);
@@ -1433,3 +1998,21 @@ int rom_load_warnings(running_machine *machine)
 {
 	return machine->romload_data->warnings;
 }
+
+
+/*-------------------------------------------------
+    rom_load_verified_key - return a CRC of the
+    hashes computed while loading, if every ROM
+    was verified without complaint
+-------------------------------------------------*/
+
+int rom_load_verified_key(running_machine *machine, UINT32 *key)
+{
+	rom_load_data *romdata = machine->romload_data;
+
+	if (!verify_rom_hash || romdata->romsverified == 0 || romdata->warnings != 0 || romdata->errors != 0)
+		return FALSE;
+
+	*key = romdata->hashkey;
+	return TRUE;
+}
@@ -276,6 +276,9 @@ void rom_init(running_machine *machine);
 /* return the number of warnings we generated */
 int rom_load_warnings(running_machine *machine);
 
+/* return a CRC of the ROM hashes computed while loading, or FALSE if they weren't all verified */
+int rom_load_verified_key(running_machine *machine, UINT32 *key);
+
 
 
 /* ----- ROM iteration ----- */
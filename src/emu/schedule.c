@@ -171,6 +171,9 @@ void device_scheduler::timeslice()
 						// note that this global variable cycles_stolen can be modified
 						// via the call to cpu_execute
 						exec->m_cycles_stolen = 0;
+
+						// idle loops are only tracked within a timeslice
+						exec->m_idle_target = ~0;
 						m_executing_device = exec;
 						*exec->m_icountptr = exec->m_cycles_running;
 						exec->execute_run();
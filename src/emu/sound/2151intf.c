@@ -39,6 +39,13 @@ static STREAM_UPDATE( ym2151_update )
 }
 
 
+static STREAM_WRITE( ym2151_write_deferred )
+{
+	ym2151_state *info = (ym2151_state *)param;
+	ym2151_write_reg(info->chip, offset, data);
+}
+
+
 static STATE_POSTLOAD( ym2151intf_postload )
 {
 	ym2151_state *info = (ym2151_state *)param;
@@ -58,6 +65,7 @@ static DEVICE_START( ym2151 )
 
 	/* stream setup */
 	info->stream = stream_create(device,0,2,rate,info,ym2151_update);
+	stream_allow_deferred_writes(info->stream);
 
 	info->chip = ym2151_init(device,device->clock(),rate);
 	assert_always(info->chip != NULL, "Error creating YM2151 chip");
@@ -78,6 +86,7 @@ static DEVICE_STOP( ym2151 )
 static DEVICE_RESET( ym2151 )
 {
 	ym2151_state *info = get_safe_token(device);
+	stream_sync(info->stream);
 	ym2151_reset_chip(info->chip);
 }
 
@@ -88,7 +97,8 @@ READ8_DEVICE_HANDLER( ym2151_r )
 
 	if (offset & 1)
 	{
-		stream_update(token->stream);
+		/* the status only comes from the timers, but a CSM key on waits for the next update */
+		stream_mark_update(token->stream);
 		return ym2151_read_status(token->chip);
 	}
 	else
@@ -101,8 +111,14 @@ WRITE8_DEVICE_HANDLER( ym2151_w )
 
 	if (offset & 1)
 	{
-		stream_update(token->stream);
-		ym2151_write_reg(token->chip, token->lastreg, data);
+		/* the timers and the CT port act on the rest of the machine; everything else is only heard */
+		if ((token->lastreg >= 0x10 && token->lastreg <= 0x14) || token->lastreg == 0x1b)
+		{
+			stream_update(token->stream);
+			ym2151_write_reg(token->chip, token->lastreg, data);
+		}
+		else
+			stream_write(token->stream, ym2151_write_deferred, token->lastreg, data);
 	}
 	else
 		token->lastreg = data;
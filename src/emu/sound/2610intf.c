@@ -26,6 +26,7 @@ struct _ym2610_state
 	void			*psg;
 	const ym2610_interface	*intf;
 	running_device		*device;
+	int			address;	/* last address written, | 0x100 on port B, or -1 if unknown */
 };
 
 
@@ -81,12 +82,15 @@ static void IRQHandler(void *param,int irq)
 static TIMER_CALLBACK( timer_callback_0 )
 {
 	ym2610_state *info = (ym2610_state *)ptr;
+	/* the sound worker must not be generating while the chip state changes */
+	stream_sync(info->stream);
 	ym2610_timer_over(info->chip,0);
 }
 
 static TIMER_CALLBACK( timer_callback_1 )
 {
 	ym2610_state *info = (ym2610_state *)ptr;
+	stream_sync(info->stream);
 	ym2610_timer_over(info->chip,1);
 }
 
@@ -127,10 +131,19 @@ static STREAM_UPDATE( ym2610b_stream_update )
 }
 
 
+/* the stream has already been generated up to the write, possibly on the sound worker */
+static STREAM_WRITE( ym2610_write_deferred )
+{
+	ym2610_state *info = (ym2610_state *)param;
+	ym2610_write_synced(info->chip, offset, data);
+}
+
+
 static STATE_POSTLOAD( ym2610_intf_postload )
 {
 	ym2610_state *info = (ym2610_state *)param;
 	ym2610_postload(info->chip);
+	info->address = -1;
 }
 
 
@@ -162,6 +175,8 @@ static DEVICE_START( ym2610 )
 
 	/* stream system initialize */
 	info->stream = stream_create(device,0,2,rate,info,(type == YM2610) ? ym2610_stream_update : ym2610b_stream_update);
+	stream_allow_deferred_writes(info->stream);
+	info->address = -1;
 	/* setup adpcm buffers */
 	pcmbufa  = *device->region();
 	pcmsizea = device->region()->bytes();
@@ -193,20 +208,60 @@ static DEVICE_STOP( ym2610 )
 static DEVICE_RESET( ym2610 )
 {
 	ym2610_state *info = get_safe_token(device);
+	stream_sync(info->stream);
 	ym2610_reset_chip(info->chip);
+	info->address = -1;
 }
 
 
 READ8_DEVICE_HANDLER( ym2610_r )
 {
 	ym2610_state *info = get_safe_token(device);
+
+	/* the SSG and the ADPCM end flags need every write applied */
+	if (offset & 3)
+		stream_sync(info->stream);
 	return ym2610_read(info->chip, offset & 3);
 }
 
 WRITE8_DEVICE_HANDLER( ym2610_w )
 {
 	ym2610_state *info = get_safe_token(device);
-	ym2610_write(info->chip, offset & 3, data);
+	int deferrable;
+
+	/* the SSG and the timers act on the rest of the machine; everything else is only heard */
+	offset &= 3;
+	switch (offset)
+	{
+		case 0:
+			info->address = data;
+			deferrable = (data >= 0x10);
+			break;
+
+		case 1:
+			deferrable = (info->address >= 0x10 && (info->address & 0xf0) != 0x20) || info->address == 0x22 || info->address == 0x28;
+			break;
+
+		case 2:
+			info->address = 0x100 | data;
+			deferrable = TRUE;
+			break;
+
+		default:
+			deferrable = TRUE;
+			break;
+	}
+
+	/* an address only matters to the data written after it */
+	if (!deferrable)
+	{
+		stream_sync(info->stream);
+		ym2610_write(info->chip, offset, data);
+	}
+	else if (offset & 1)
+		stream_write(info->stream, ym2610_write_deferred, offset, data);
+	else
+		stream_latch(info->stream, ym2610_write_deferred, offset, data);
 }
 
 
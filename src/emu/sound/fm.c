@@ -4303,9 +4303,9 @@ void ym2610_reset_chip(void *chip)
 /* n = number  */
 /* a = address */
 /* v = value   */
-int ym2610_write(void *chip, int a, UINT8 v)
+/* update = ask for the stream to be brought up to date first */
+static int ym2610_write_reg(YM2610 *F2610, int a, UINT8 v, int update)
 {
-	YM2610 *F2610 = (YM2610 *)chip;
 	FM_OPN *OPN   = &F2610->OPN;
 	int addr;
 	int ch;
@@ -4335,7 +4335,7 @@ int ym2610_write(void *chip, int a, UINT8 v)
 			(*OPN->ST.SSG->write)(OPN->ST.param,a,v);
 			break;
 		case 0x10: /* DeltaT ADPCM */
-			ym2610_update_req(OPN->ST.param);
+			if (update) ym2610_update_req(OPN->ST.param);
 
 			switch(addr)
 			{
@@ -4375,11 +4375,11 @@ int ym2610_write(void *chip, int a, UINT8 v)
 
 			break;
 		case 0x20:	/* Mode Register */
-			ym2610_update_req(OPN->ST.param);
+			if (update) ym2610_update_req(OPN->ST.param);
 			OPNWriteMode(OPN,addr,v);
 			break;
 		default:	/* OPN section */
-			ym2610_update_req(OPN->ST.param);
+			if (update) ym2610_update_req(OPN->ST.param);
 			/* write register */
 			OPNWriteReg(OPN,addr,v);
 		}
@@ -4394,7 +4394,7 @@ int ym2610_write(void *chip, int a, UINT8 v)
 		if (F2610->addr_A1 != 1)
 			break;	/* verified on real YM2608 */
 
-		ym2610_update_req(OPN->ST.param);
+		if (update) ym2610_update_req(OPN->ST.param);
 		addr = OPN->ST.address;
 		F2610->REGS[addr | 0x100] = v;
 		if( addr < 0x30 )
@@ -4406,6 +4406,17 @@ int ym2610_write(void *chip, int a, UINT8 v)
 	return OPN->ST.irq;
 }
 
+int ym2610_write(void *chip, int a, UINT8 v)
+{
+	return ym2610_write_reg((YM2610 *)chip, a, v, TRUE);
+}
+
+/* for callers that have already brought the stream up to the time of the write */
+int ym2610_write_synced(void *chip, int a, UINT8 v)
+{
+	return ym2610_write_reg((YM2610 *)chip, a, v, FALSE);
+}
+
 UINT8 ym2610_read(void *chip,int a)
 {
 	YM2610 *F2610 = (YM2610 *)chip;
@@ -192,6 +192,7 @@ void ym2610b_update_one(void *chip, FMSAMPLE **buffer, int length);
 #endif /* BUILD_YM2610B */
 
 int ym2610_write(void *chip, int a,unsigned char v);
+int ym2610_write_synced(void *chip, int a,unsigned char v);
 unsigned char ym2610_read(void *chip,int a);
 int ym2610_timer_over(void *chip, int c );
 void ym2610_postload(void *chip);
@@ -179,6 +179,7 @@ void okim6295_device::device_start()
 	// create the stream
 	int divisor = m_config.m_pin7 ? 132 : 165;
 	m_stream = stream_create(this, 0, 1, clock() / divisor, this, static_stream_generate);
+	stream_allow_deferred_writes(m_stream);
 
 	state_save_register_device_item(this, 0, m_command);
 	state_save_register_device_item(this, 0, m_bank_offs);
@@ -331,53 +332,8 @@ void okim6295_device::write_command(UINT8 command)
 		if (voicemask != 0 && voicemask != 1 && voicemask != 2 && voicemask != 4 && voicemask != 8)
 			popmessage("OKI6295 start %x contact MAMEDEV", voicemask);
 
-		// update the stream
-		stream_update(m_stream);
-
-		// determine which voice(s) (voice is set by a 1 bit in the upper 4 bits of the second byte)
-		for (int voicenum = 0; voicenum < OKIM6295_VOICES; voicenum++, voicemask >>= 1)
-			if (voicemask & 1)
-			{
-				okim_voice &voice = m_voice[voicenum];
-
-				// determine the start/stop positions
-				offs_t base = m_command * 8;
-
-				offs_t start = m_direct->read_raw_byte(base + 0) << 16;
-				start |= m_direct->read_raw_byte(base + 1) << 8;
-				start |= m_direct->read_raw_byte(base + 2) << 0;
-				start &= 0x3ffff;
-
-				offs_t stop = m_direct->read_raw_byte(base + 3) << 16;
-				stop |= m_direct->read_raw_byte(base + 4) << 8;
-				stop |= m_direct->read_raw_byte(base + 5) << 0;
-				stop &= 0x3ffff;
-
-				// set up the voice to play this sample
-				if (start < stop)
-				{
-					if (!voice.m_playing) // fixes Got-cha and Steel Force
-					{
-						voice.m_playing = true;
-						voice.m_base_offset = start;
-						voice.m_sample = 0;
-						voice.m_count = 2 * (stop - start + 1);
-
-						// also reset the ADPCM parameters
-						voice.m_adpcm.reset();
-						voice.m_volume = s_volume_table[command & 0x0f];
-					}
-					else
-						logerror("OKIM6295:'%s' requested to play sample %02x on non-stopped voice\n",tag(),m_command);
-				}
-
-				// invalid samples go here
-				else
-				{
-					logerror("OKIM6295:'%s' requested to play invalid sample %02x\n",tag(),m_command);
-					voice.m_playing = false;
-				}
-			}
+		// update the stream, then start the voices
+		stream_write(m_stream, static_start_voices, m_command, command);
 
 		// reset the command
 		m_command = -1;
@@ -391,17 +347,89 @@ void okim6295_device::write_command(UINT8 command)
 	else
 	{
 		// update the stream, then turn it off
-		stream_update(m_stream);
-
-		// determine which voice(s) (voice is set by a 1 bit in bits 3-6 of the command
-		int voicemask = command >> 3;
-		for (int voicenum = 0; voicenum < OKIM6295_VOICES; voicenum++, voicemask >>= 1)
-			if (voicemask & 1)
-				m_voice[voicenum].m_playing = false;
+		// (voice is set by a 1 bit in bits 3-6 of the command)
+		stream_write(m_stream, static_stop_voices, 0, command >> 3);
 	}
 }
 
 
+//-------------------------------------------------
+//  start_voices - start playing a sample on the
+//  voices in the upper 4 bits of the command
+//-------------------------------------------------
+
+STREAM_WRITE( okim6295_device::static_start_voices )
+{
+	reinterpret_cast<okim6295_device *>(param)->start_voices(offset, data);
+}
+
+void okim6295_device::start_voices(int sample, UINT8 command)
+{
+	// determine which voice(s) (voice is set by a 1 bit in the upper 4 bits of the second byte)
+	int voicemask = command >> 4;
+	for (int voicenum = 0; voicenum < OKIM6295_VOICES; voicenum++, voicemask >>= 1)
+		if (voicemask & 1)
+		{
+			okim_voice &voice = m_voice[voicenum];
+
+			// determine the start/stop positions
+			offs_t base = sample * 8;
+
+			offs_t start = m_direct->read_raw_byte(base + 0) << 16;
+			start |= m_direct->read_raw_byte(base + 1) << 8;
+			start |= m_direct->read_raw_byte(base + 2) << 0;
+			start &= 0x3ffff;
+
+			offs_t stop = m_direct->read_raw_byte(base + 3) << 16;
+			stop |= m_direct->read_raw_byte(base + 4) << 8;
+			stop |= m_direct->read_raw_byte(base + 5) << 0;
+			stop &= 0x3ffff;
+
+			// set up the voice to play this sample
+			if (start < stop)
+			{
+				if (!voice.m_playing) // fixes Got-cha and Steel Force
+				{
+					voice.m_playing = true;
+					voice.m_base_offset = start;
+					voice.m_sample = 0;
+					voice.m_count = 2 * (stop - start + 1);
+
+					// also reset the ADPCM parameters
+					voice.m_adpcm.reset();
+					voice.m_volume = s_volume_table[command & 0x0f];
+				}
+				else
+					logerror("OKIM6295:'%s' requested to play sample %02x on non-stopped voice\n",tag(),sample);
+			}
+
+			// invalid samples go here
+			else
+			{
+				logerror("OKIM6295:'%s' requested to play invalid sample %02x\n",tag(),sample);
+				voice.m_playing = false;
+			}
+		}
+}
+
+
+//-------------------------------------------------
+//  stop_voices - silence the voices in a mask
+//-------------------------------------------------
+
+STREAM_WRITE( okim6295_device::static_stop_voices )
+{
+	reinterpret_cast<okim6295_device *>(param)->stop_voices(data);
+}
+
+void okim6295_device::stop_voices(int voicemask)
+{
+	for (int voicenum = 0; voicenum < OKIM6295_VOICES; voicenum++, voicemask >>= 1)
+		if (voicemask & 1)
+			m_voice[voicenum].m_playing = false;
+}
+
+
 //-------------------------------------------------
 //  write - memory interface for write
 //-------------------------------------------------
@@ -136,6 +136,12 @@ protected:
 	// internal callbacks
 	static STREAM_UPDATE( static_stream_generate );
 	virtual void stream_generate(stream_sample_t **inputs, stream_sample_t **outputs, int samples);
+	static STREAM_WRITE( static_start_voices );
+	static STREAM_WRITE( static_stop_voices );
+
+	// helpers
+	void start_voices(int sample, UINT8 command);
+	void stop_voices(int voicemask);
 
 	// a single voice
 	class okim_voice
@@ -42,12 +42,27 @@ Debug defines
 #define VERBOSE		0
 #define LOG(x)	do { if (VERBOSE) logerror x; } while (0)
 
+/* mix with the host vector unit; define QSOUND_NO_SIMD to force the scalar path. */
+/* The NEON mix is unverified, so ARM builds stay scalar unless */
+/* QSOUND_NEON_EXPERIMENTAL is defined; retrobench -qsound checks it */
+#if !defined(QSOUND_NO_SIMD)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define QSOUND_SSE2
+#elif defined(QSOUND_NEON_EXPERIMENTAL) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#define QSOUND_NEON
+#endif
+#endif
+
 /* 8 bit source ROM samples */
 typedef INT8 QSOUND_SRC_SAMPLE;
 
 
 #define QSOUND_CLOCKDIV 166			 /* Clock divider */
 #define QSOUND_CHANNELS 16
+#define QSOUND_MIX_BLOCK 256		 /* samples rendered per channel before mixing */
+#define QSOUND_BENCH_SAMPLES 1024	 /* longest update qsound_benchmark asks for */
 typedef stream_sample_t QSOUND_SAMPLE;
 
 struct QSOUND_CHANNEL
@@ -98,6 +113,7 @@ INLINE qsound_state *get_safe_token(running_device *device)
 
 /* Function prototypes */
 static STREAM_UPDATE( qsound_update );
+static STREAM_WRITE( qsound_write_deferred );
 static void qsound_set_command(qsound_state *chip, int data, int value);
 
 static DEVICE_START( qsound )
@@ -129,6 +145,7 @@ static DEVICE_START( qsound )
 			device->clock() / QSOUND_CLOCKDIV,
 			chip,
 			qsound_update );
+		stream_allow_deferred_writes(chip->stream);
 	}
 
 	if (LOG_WAVE)
@@ -184,7 +201,8 @@ WRITE8_DEVICE_HANDLER( qsound_w )
 			break;
 
 		case 2:
-			qsound_set_command(chip, data, chip->data);
+			/* the latch stays here; the command is heard from the next update */
+			stream_latch(chip->stream, qsound_write_deferred, data, chip->data);
 			break;
 
 		default:
@@ -199,6 +217,11 @@ READ8_DEVICE_HANDLER( qsound_r )
 	return 0x80;
 }
 
+static STREAM_WRITE( qsound_write_deferred )
+{
+	qsound_set_command((qsound_state *)param, offset, data);
+}
+
 static void qsound_set_command(qsound_state *chip, int data, int value)
 {
 	int ch=0,reg=0;
@@ -312,25 +335,219 @@ static void qsound_set_command(qsound_state *chip, int data, int value)
 }
 
 
-static STREAM_UPDATE( qsound_update )
+/*-------------------------------------------------
+    qsound_channel_render - step a channel through
+    up to count samples, storing the sample value
+    heard at each one; returns how many were
+    produced before the channel keyed off
+-------------------------------------------------*/
+
+static int qsound_channel_render(qsound_state *chip, struct QSOUND_CHANNEL *pC, INT32 *dest, int count)
+{
+	int done = 0;
+
+	while (done < count)
+	{
+		/* the ROM can be addressed linearly up to the end of the sample or the point where bank+address wraps */
+		UINT32 start = (UINT32)(pC->bank + pC->address) % chip->sample_rom_length;
+		INT64 stop = MIN((INT64)pC->end, (INT64)pC->address + (chip->sample_rom_length - start));
+		INT64 limit = MAX(stop - pC->address, 1);
+		INT64 room = (limit << 16) - pC->offset;
+		int run = count - done;
+
+		/* every sample whose step stays short of the boundary is a plain add */
+		if (room <= 0)
+			run = 0;
+		else if (pC->pitch > 0 && (room + pC->pitch - 1) / pC->pitch < run)
+			run = (room + pC->pitch - 1) / pC->pitch;
+
+		if (run > 0)
+		{
+			/* offset position of each sample counted from the run start; samples before the first step repeat lastdt */
+			const QSOUND_SRC_SAMPLE *src = chip->sample_rom + start;
+			UINT64 acc = pC->offset;
+			INT32 *dp = dest + done;
+			int j = 0;
+
+			for ( ; j < run && (acc >> 16) == 0; j++, acc += pC->pitch)
+				dp[j] = pC->lastdt;
+			for ( ; j < run; j++, acc += pC->pitch)
+				dp[j] = src[acc >> 16];
+
+			/* leave the channel as if it had been stepped sample by sample */
+			UINT32 steps = (acc - pC->pitch) >> 16;
+			if (steps)
+			{
+				pC->address += steps;
+				pC->lastdt = src[steps];
+			}
+			pC->offset = acc - ((UINT64)steps << 16);
+			done += run;
+			if (done == count)
+				break;
+		}
+
+		/* this sample crosses the boundary; step it the long way */
+		pC->address += pC->offset >> 16;
+		pC->offset &= 0xffff;
+		if (pC->address >= pC->end)
+		{
+			if (!pC->loop)
+			{
+				/* Reached the end of a non-looped sample */
+				pC->key = 0;
+				break;
+			}
+			/* Reached the end, restart the loop */
+			pC->address = (pC->end - pC->loop) & 0xffff;
+		}
+		pC->lastdt = chip->sample_rom[(pC->bank + pC->address) % chip->sample_rom_length];
+		dest[done++] = pC->lastdt;
+		pC->offset += pC->pitch;
+	}
+
+	return done;
+}
+
+
+/*-------------------------------------------------
+    qsound_mix - sum a block of rendered channels
+    into both outputs at their volumes
+-------------------------------------------------*/
+
+INLINE void qsound_mix(stream_sample_t *pOutL, stream_sample_t *pOutR, INT32 data[][QSOUND_MIX_BLOCK], const int *lvol, const int *rvol, int channels, int count)
+{
+	int i = 0;
+
+#if defined(QSOUND_SSE2)
+	/* SSE2 has no 32-bit multiply; the samples are 8-bit and the volumes 16-bit, */
+	/* so split each volume at bit 7 and let pmaddwd sum data*128*hi + data*lo */
+	__m128i lmul[QSOUND_CHANNELS], rmul[QSOUND_CHANNELS];
+	const __m128i lowmask = _mm_set1_epi32(0xffff);
+
+	for (int ch = 0; ch < channels; ch++)
+	{
+		lmul[ch] = _mm_set1_epi32(((lvol[ch] & 0x7f) << 16) | (lvol[ch] >> 7));
+		rmul[ch] = _mm_set1_epi32(((rvol[ch] & 0x7f) << 16) | (rvol[ch] >> 7));
+	}
+
+	for ( ; i + 4 <= count; i += 4)
+	{
+		__m128i left = _mm_setzero_si128();
+		__m128i right = _mm_setzero_si128();
+
+		for (int ch = 0; ch < channels; ch++)
+		{
+			__m128i dt = _mm_loadu_si128((const __m128i *)&data[ch][i]);
+			__m128i pair = _mm_or_si128(_mm_and_si128(_mm_slli_epi32(dt, 7), lowmask), _mm_slli_epi32(dt, 16));
+
+			left = _mm_add_epi32(left, _mm_srai_epi32(_mm_madd_epi16(pair, lmul[ch]), 6));
+			right = _mm_add_epi32(right, _mm_srai_epi32(_mm_madd_epi16(pair, rmul[ch]), 6));
+		}
+		_mm_storeu_si128((__m128i *)&pOutL[i], left);
+		_mm_storeu_si128((__m128i *)&pOutR[i], right);
+	}
+#elif defined(QSOUND_NEON)
+	int32x4_t lmul[QSOUND_CHANNELS], rmul[QSOUND_CHANNELS];
+
+	for (int ch = 0; ch < channels; ch++)
+	{
+		lmul[ch] = vdupq_n_s32(lvol[ch]);
+		rmul[ch] = vdupq_n_s32(rvol[ch]);
+	}
+
+	for ( ; i + 4 <= count; i += 4)
+	{
+		int32x4_t left = vdupq_n_s32(0);
+		int32x4_t right = vdupq_n_s32(0);
+
+		for (int ch = 0; ch < channels; ch++)
+		{
+			int32x4_t dt = vld1q_s32(&data[ch][i]);
+
+			left = vaddq_s32(left, vshrq_n_s32(vmulq_s32(dt, lmul[ch]), 6));
+			right = vaddq_s32(right, vshrq_n_s32(vmulq_s32(dt, rmul[ch]), 6));
+		}
+		vst1q_s32(&pOutL[i], left);
+		vst1q_s32(&pOutR[i], right);
+	}
+#endif
+
+	for ( ; i < count; i++)
+	{
+		stream_sample_t left = 0, right = 0;
+
+		for (int ch = 0; ch < channels; ch++)
+		{
+			left += (data[ch][i] * lvol[ch]) >> 6;
+			right += (data[ch][i] * rvol[ch]) >> 6;
+		}
+		pOutL[i] = left;
+		pOutR[i] = right;
+	}
+}
+
+
+/*-------------------------------------------------
+    qsound_render - render and mix every keyed
+    channel into both outputs
+-------------------------------------------------*/
+
+static void qsound_render(qsound_state *chip, stream_sample_t **outputs, int samples)
+{
+	int i;
+	int rvol[QSOUND_CHANNELS], lvol[QSOUND_CHANNELS];
+	struct QSOUND_CHANNEL *pC;
+	INT32 data[QSOUND_CHANNELS][QSOUND_MIX_BLOCK];
+
+	/* render every keyed channel a block at a time, then sum the block into both outputs in one pass */
+	for (int pos = 0; pos < samples; pos += QSOUND_MIX_BLOCK)
+	{
+		int count = MIN(samples - pos, QSOUND_MIX_BLOCK);
+		int channels = 0;
+
+		pC=&chip->channel[0];
+		for (i=0; i<QSOUND_CHANNELS; i++, pC++)
+		{
+			if (pC->key)
+			{
+				int rendered = qsound_channel_render(chip, pC, data[channels], count);
+
+				/* a channel that keys off is silent for the rest of the block */
+				if (rendered < count)
+					memset(&data[channels][rendered], 0, (count - rendered) * sizeof(data[0][0]));
+				rvol[channels]=(pC->rvol*pC->vol)>>8;
+				lvol[channels]=(pC->lvol*pC->vol)>>8;
+				channels++;
+			}
+		}
+		qsound_mix(outputs[0] + pos, outputs[1] + pos, data, lvol, rvol, channels, count);
+	}
+}
+
+
+/*-------------------------------------------------
+    qsound_render_reference - the original
+    sample-by-sample renderer, kept so that
+    qsound_benchmark can check qsound_render
+    against it
+-------------------------------------------------*/
+
+static void qsound_render_reference(qsound_state *chip, stream_sample_t **outputs, int samples)
 {
-	qsound_state *chip = (qsound_state *)param;
 	int i,j;
 	int rvol, lvol, count;
 	struct QSOUND_CHANNEL *pC=&chip->channel[0];
-	stream_sample_t  *datap[2];
 
-	datap[0] = outputs[0];
-	datap[1] = outputs[1];
-	memset( datap[0], 0x00, samples * sizeof(*datap[0]) );
-	memset( datap[1], 0x00, samples * sizeof(*datap[1]) );
+	memset( outputs[0], 0x00, samples * sizeof(*outputs[0]) );
+	memset( outputs[1], 0x00, samples * sizeof(*outputs[1]) );
 
 	for (i=0; i<QSOUND_CHANNELS; i++)
 	{
 		if (pC->key)
 		{
-			QSOUND_SAMPLE *pOutL=datap[0];
-			QSOUND_SAMPLE *pOutR=datap[1];
+			QSOUND_SAMPLE *pOutL=outputs[0];
+			QSOUND_SAMPLE *pOutR=outputs[1];
 			rvol=(pC->rvol*pC->vol)>>8;
 			lvol=(pC->lvol*pC->vol)>>8;
 
@@ -364,11 +581,110 @@ static STREAM_UPDATE( qsound_update )
 		}
 		pC++;
 	}
+}
+
+
+static STREAM_UPDATE( qsound_update )
+{
+	qsound_state *chip = (qsound_state *)param;
+
+	qsound_render(chip, outputs, samples);
 
 	if (chip->fpRawDataL)
-		fwrite(datap[0], samples*sizeof(QSOUND_SAMPLE), 1, chip->fpRawDataL);
+		fwrite(outputs[0], samples*sizeof(QSOUND_SAMPLE), 1, chip->fpRawDataL);
 	if (chip->fpRawDataR)
-		fwrite(datap[1], samples*sizeof(QSOUND_SAMPLE), 1, chip->fpRawDataR);
+		fwrite(outputs[1], samples*sizeof(QSOUND_SAMPLE), 1, chip->fpRawDataR);
+}
+
+
+/*-------------------------------------------------
+    qsound_benchmark - replay one random register
+    trace through the reference renderer and the
+    block renderer from the chip's current state,
+    timing both; returns the number of updates
+    whose output or channel state differed
+-------------------------------------------------*/
+
+int qsound_benchmark(running_device *device, int updates, osd_ticks_t *reference, osd_ticks_t *block)
+{
+	qsound_state *chip = get_safe_token(device);
+	struct QSOUND_CHANNEL saved[QSOUND_CHANNELS], state[2][QSOUND_CHANNELS];
+	stream_sample_t *buffer = global_alloc_array(stream_sample_t, 4 * QSOUND_BENCH_SAMPLES);
+	stream_sample_t *output[2][2] =
+	{
+		{ buffer, buffer + QSOUND_BENCH_SAMPLES },
+		{ buffer + 2 * QSOUND_BENCH_SAMPLES, buffer + 3 * QSOUND_BENCH_SAMPLES }
+	};
+	osd_ticks_t *ticks[2] = { reference, block };
+	int mismatches = 0;
+	UINT32 seed = 1;
+
+	/* the sound worker has to be done with the channels first */
+	stream_sync(chip->stream);
+	memcpy(saved, chip->channel, sizeof(saved));
+	memcpy(state[0], saved, sizeof(saved));
+	memcpy(state[1], saved, sizeof(saved));
+	*reference = *block = 0;
+
+	for (int update = 0; update < updates; update++)
+	{
+		int writes, samples;
+
+		/* a private generator, so that the machine's random sequence is left alone */
+		seed = seed * 1103515245 + 12345;
+		samples = (seed >> 16) % QSOUND_BENCH_SAMPLES + 1;
+		writes = (seed >> 8) & 7;
+
+		/* keys, pitches, loops and ends land anywhere, so runs hit the loop point, the end and the ROM wrap */
+		for (int index = 0; index < writes; index++)
+		{
+			int ch, reg, value;
+
+			seed = seed * 1103515245 + 12345;
+			ch = (seed >> 12) & 0x0f;
+			reg = (seed >> 16) % 9;
+			value = (seed >> 8) & 0xffff;
+			if (reg == 2)
+				value &= (seed & 0x80000000) ? 0x3fff : 0x0fff;
+			else if (reg == 4 || reg == 6)
+				value &= (seed & 0x80000000) ? 0x1fff : 0;
+			else if (reg == 8)
+				value = 0x110 + value % 0x21;
+
+			for (int path = 0; path < 2; path++)
+			{
+				memcpy(chip->channel, state[path], sizeof(chip->channel));
+				qsound_set_command(chip, (reg < 8) ? (ch << 3) | reg : 0x80 + ch, value);
+				memcpy(state[path], chip->channel, sizeof(chip->channel));
+			}
+		}
+
+		/* the same update through both paths */
+		for (int path = 0; path < 2; path++)
+		{
+			memcpy(chip->channel, state[path], sizeof(chip->channel));
+			osd_ticks_t start = osd_ticks();
+			if (path == 0)
+				qsound_render_reference(chip, output[path], samples);
+			else
+				qsound_render(chip, output[path], samples);
+			*ticks[path] += osd_ticks() - start;
+			memcpy(state[path], chip->channel, sizeof(chip->channel));
+		}
+
+		if (memcmp(output[0][0], output[1][0], samples * sizeof(stream_sample_t)) != 0 ||
+			memcmp(output[0][1], output[1][1], samples * sizeof(stream_sample_t)) != 0 ||
+			memcmp(state[0], state[1], sizeof(state[0])) != 0)
+		{
+			/* carry on from the reference state so that one slip is only counted once */
+			memcpy(state[1], state[0], sizeof(state[0]));
+			mismatches++;
+		}
+	}
+
+	memcpy(chip->channel, saved, sizeof(chip->channel));
+	global_free(buffer);
+	return mismatches;
 }
 
 
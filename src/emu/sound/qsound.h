@@ -16,6 +16,8 @@
 WRITE8_DEVICE_HANDLER( qsound_w );
 READ8_DEVICE_HANDLER( qsound_r );
 
+int qsound_benchmark(running_device *device, int updates, osd_ticks_t *reference, osd_ticks_t *block);
+
 DECLARE_LEGACY_SOUND_DEVICE(QSOUND, qsound);
 
 #endif /* __QSOUND_H__ */
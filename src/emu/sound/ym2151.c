@@ -828,7 +828,11 @@ static TIMER_CALLBACK( timer_callback_a )
 		timer_set(machine, attotime_zero,chip,0,irqAon_callback);
 	}
 	if (chip->irq_enable & 0x80)
+	{
+		/* the sound worker must not be generating while we ask */
+		stream_sync(stream_find_by_device(chip->device, 0));
 		chip->csm_req = 2;		/* request KEY ON / KEY OFF sequence */
+	}
 }
 static TIMER_CALLBACK( timer_callback_b )
 {
@@ -16,7 +16,7 @@
     09      Flags
     0A..1B  Game name padded with \0
     1C..1F  Signature
-    20..end Save game data (compressed)
+    20..end Save game data (compressed in files, raw in memory buffers)
 
     Data is always written as native-endian.
     Data is converted from the endiannness it was written upon load.
@@ -46,6 +46,8 @@
 #define SAVE_VERSION		2
 #define HEADER_SIZE			32
 
+#define REWIND_CHUNK		16				/* granularity of the delta comparison */
+
 /* Available flags */
 enum
 {
@@ -68,6 +70,32 @@ struct _state_entry
 	UINT8				typesize;			/* size of the raw data type */
 	UINT32				typecount;			/* number of items */
 	UINT32				offset;				/* offset within the final structure */
+	UINT8				tracked;			/* owner reports writes through the dirty flag */
+	UINT8				dirty;				/* written since the last rewind snapshot? */
+};
+
+
+typedef struct _state_rewind_slot state_rewind_slot;
+struct _state_rewind_slot
+{
+	UINT32				offset;				/* offset of the delta within the ring */
+	UINT32				size;				/* size of the encoded delta */
+};
+
+
+typedef struct _state_rewind state_rewind;
+struct _state_rewind
+{
+	UINT8 *				reference;			/* most recent snapshot; deltas lead back from here */
+	UINT8				refvalid;			/* has the reference been captured yet? */
+	UINT8 *				scratch;			/* room to encode one worst-case delta */
+	UINT8 *				ring;				/* ring buffer of encoded deltas */
+	UINT32				ringsize;			/* size of the ring buffer */
+	UINT32				head;				/* next free offset in the ring */
+	state_rewind_slot *	slot;				/* one slot per delta, oldest first */
+	UINT32				slots;				/* maximum number of deltas */
+	UINT32				first;				/* index of the oldest delta */
+	UINT32				count;				/* number of deltas held */
 };
 
 
@@ -98,6 +126,9 @@ struct _state_private
 	UINT8 *				ioarray;			/* array where we accumulate all the data */
 	UINT32				ioarraysize;		/* size of the array */
 	mame_file *			iofile;				/* file currently in use */
+
+	UINT32				buffersize;			/* size of an uncompressed in-memory state */
+	state_rewind *		rewind;				/* delta rewind history, if enabled */
 };
 
 
@@ -154,6 +185,21 @@ INLINE void flip_data(state_entry *entry)
 
 
 
+/*-------------------------------------------------
+    mark_all_dirty - flag every tracked entry as
+    modified after its data was replaced
+-------------------------------------------------*/
+
+INLINE void mark_all_dirty(state_private *global)
+{
+	state_entry *entry;
+
+	for (entry = global->entrylist; entry != NULL; entry = entry->next)
+		entry->dirty = TRUE;
+}
+
+
+
 /***************************************************************************
     INITIALIZATION
 ***************************************************************************/
@@ -236,10 +282,20 @@ int state_save_get_reg_count(running_machine *machine)
 
 void state_save_allow_registration(running_machine *machine, int allowed)
 {
+	state_private *global = machine->state_data;
+	state_entry *entry;
+
 	/* allow/deny registration */
-	machine->state_data->reg_allowed = allowed;
+	global->reg_allowed = allowed;
 	if (!allowed)
+	{
+		/* the entry list is now fixed, so the in-memory state size is too */
+		global->buffersize = HEADER_SIZE;
+		for (entry = global->entrylist; entry != NULL; entry = entry->next)
+			global->buffersize += entry->typesize * entry->typecount;
+
 		state_save_dump_registry(machine);
+	}
 }
 
 
@@ -321,6 +377,31 @@ void state_save_register_bitmap(running_machine *machine, const char *module, co
 }
 
 
+/*-------------------------------------------------
+    state_save_track_dirty - return a flag the
+    owner of a registered block sets whenever it
+    writes to it, so rewind snapshots can skip
+    the block while it stays clean
+-------------------------------------------------*/
+
+UINT8 *state_save_track_dirty(running_machine *machine, void *val)
+{
+	state_private *global = machine->state_data;
+	state_entry *entry;
+
+	for (entry = global->entrylist; entry != NULL; entry = entry->next)
+		if (entry->data == val)
+		{
+			entry->tracked = TRUE;
+			entry->dirty = TRUE;
+			return &entry->dirty;
+		}
+
+	fatalerror("Dirty tracking requested for an unregistered save state entry (%p)", val);
+	return NULL;
+}
+
+
 
 /***************************************************************************
     CALLBACK FUNCTION REGISTRATION
@@ -501,6 +582,24 @@ state_save_error state_save_check_file(running_machine *machine, mame_file *file
 }
 
 
+/*-------------------------------------------------
+    build_header - fill in a save state header
+    for the current machine
+-------------------------------------------------*/
+
+static void build_header(running_machine *machine, UINT8 *header)
+{
+	UINT32 signature = get_signature(machine);
+
+	memset(header, 0, HEADER_SIZE);
+	memcpy(&header[0], ss_magic_num, 8);
+	header[8] = SAVE_VERSION;
+	header[9] = NATIVE_ENDIAN_VALUE_LE_BE(0, SS_MSB_FIRST);
+	strncpy((char *)&header[0x0a], machine->gamedrv->name, 0x1c - 0x0a);
+	*(UINT32 *)&header[0x1c] = LITTLE_ENDIANIZE_INT32(signature);
+}
+
+
 /*-------------------------------------------------
     state_save_write_file - writes the data to
     a file
@@ -509,7 +608,6 @@ state_save_error state_save_check_file(running_machine *machine, mame_file *file
 state_save_error state_save_write_file(running_machine *machine, mame_file *file)
 {
 	state_private *global = machine->state_data;
-	UINT32 signature = get_signature(machine);
 	UINT8 header[HEADER_SIZE];
 	state_callback *func;
 	state_entry *entry;
@@ -519,11 +617,7 @@ state_save_error state_save_write_file(running_machine *machine, mame_file *file
 		return STATERR_ILLEGAL_REGISTRATIONS;
 
 	/* generate the header */
-	memcpy(&header[0], ss_magic_num, 8);
-	header[8] = SAVE_VERSION;
-	header[9] = NATIVE_ENDIAN_VALUE_LE_BE(0, SS_MSB_FIRST);
-	strncpy((char *)&header[0x0a], machine->gamedrv->name, 0x1c - 0x0a);
-	*(UINT32 *)&header[0x1c] = LITTLE_ENDIANIZE_INT32(signature);
+	build_header(machine, header);
 
 	/* write the header and turn on compression for the rest of the file */
 	mame_fcompress(file, FCOMPRESS_NONE);
@@ -579,6 +673,9 @@ state_save_error state_save_read_file(running_machine *machine, mame_file *file)
 	/* determine whether or not to flip the data when done */
 	flip = NATIVE_ENDIAN_VALUE_LE_BE((header[9] & SS_MSB_FIRST) != 0, (header[9] & SS_MSB_FIRST) == 0);
 
+	/* the sound worker must be done with the devices we overwrite */
+	streams_sync(machine);
+
 	/* read all the data, flipping if necessary */
 	for (entry = global->entrylist; entry != NULL; entry = entry->next)
 	{
@@ -590,6 +687,123 @@ state_save_error state_save_read_file(running_machine *machine, mame_file *file)
 		if (flip)
 			flip_data(entry);
 	}
+	mark_all_dirty(global);
+
+	/* call the post-load functions */
+	for (func = global->postfunclist; func != NULL; func = func->next)
+		(*func->func.postload)(machine, func->param);
+
+	return STATERR_NONE;
+}
+
+
+
+/***************************************************************************
+    IN-MEMORY SAVE STATE PROCESSING
+***************************************************************************/
+
+/*-------------------------------------------------
+    state_save_get_buffer_size - return the size
+    of an uncompressed in-memory save state
+-------------------------------------------------*/
+
+UINT32 state_save_get_buffer_size(running_machine *machine)
+{
+	state_private *global = machine->state_data;
+
+	/* the size is only fixed once registrations are closed */
+	if (global->reg_allowed)
+		return 0;
+
+	return global->buffersize;
+}
+
+
+/*-------------------------------------------------
+    state_save_write_buffer - write the header
+    and all registered data, uncompressed, into
+    a caller-provided buffer
+-------------------------------------------------*/
+
+state_save_error state_save_write_buffer(running_machine *machine, void *buffer, UINT32 size)
+{
+	state_private *global = machine->state_data;
+	UINT8 *dest = (UINT8 *)buffer;
+	state_callback *func;
+	state_entry *entry;
+
+	/* if we have illegal registrations, return an error */
+	if (global->illegal_regs > 0)
+		return STATERR_ILLEGAL_REGISTRATIONS;
+
+	/* the buffer must hold the whole state */
+	if (global->reg_allowed || size < global->buffersize)
+		return STATERR_WRITE_ERROR;
+
+	/* generate the header */
+	build_header(machine, dest);
+	dest += HEADER_SIZE;
+
+	/* call the pre-save functions */
+	for (func = global->prefunclist; func != NULL; func = func->next)
+		(*func->func.presave)(machine, func->param);
+
+	/* then copy all the data */
+	for (entry = global->entrylist; entry != NULL; entry = entry->next)
+	{
+		UINT32 totalsize = entry->typesize * entry->typecount;
+		memcpy(dest, entry->data, totalsize);
+		dest += totalsize;
+	}
+	return STATERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    state_save_read_buffer - restore all
+    registered data from an uncompressed
+    in-memory save state
+-------------------------------------------------*/
+
+state_save_error state_save_read_buffer(running_machine *machine, const void *buffer, UINT32 size)
+{
+	state_private *global = machine->state_data;
+	const UINT8 *src = (const UINT8 *)buffer;
+	state_callback *func;
+	state_entry *entry;
+	int flip;
+
+	/* if we have illegal registrations, return an error */
+	if (global->illegal_regs > 0)
+		return STATERR_ILLEGAL_REGISTRATIONS;
+
+	/* the buffer must hold the whole state */
+	if (global->reg_allowed || size < global->buffersize)
+		return STATERR_READ_ERROR;
+
+	/* verify the header and report an error if it doesn't match */
+	if (validate_header(src, machine->gamedrv->name, get_signature(machine), popmessage, "Error: ") != STATERR_NONE)
+		return STATERR_INVALID_HEADER;
+
+	/* determine whether or not to flip the data when done */
+	flip = NATIVE_ENDIAN_VALUE_LE_BE((src[9] & SS_MSB_FIRST) != 0, (src[9] & SS_MSB_FIRST) == 0);
+	src += HEADER_SIZE;
+
+	/* the sound worker must be done with the devices we overwrite */
+	streams_sync(machine);
+
+	/* copy all the data, flipping if necessary */
+	for (entry = global->entrylist; entry != NULL; entry = entry->next)
+	{
+		UINT32 totalsize = entry->typesize * entry->typecount;
+		memcpy(entry->data, src, totalsize);
+		src += totalsize;
+
+		/* handle flipping */
+		if (flip)
+			flip_data(entry);
+	}
+	mark_all_dirty(global);
 
 	/* call the post-load functions */
 	for (func = global->postfunclist; func != NULL; func = func->next)
@@ -600,6 +814,270 @@ state_save_error state_save_read_file(running_machine *machine, mame_file *file)
 
 
 
+/***************************************************************************
+    DELTA REWIND HISTORY
+***************************************************************************/
+
+/*-------------------------------------------------
+    rewind_encode - compare the live data against
+    the reference, write the XOR of every changed
+    chunk as (skip, length, data) runs and bring
+    the reference up to date
+-------------------------------------------------*/
+
+static UINT32 rewind_encode(state_private *global, UINT8 *dest)
+{
+	UINT8 *ref = global->rewind->reference + HEADER_SIZE;
+	UINT8 *out = dest;
+	UINT8 *runlength = NULL;
+	UINT32 skip = 0, run = 0;
+	state_entry *entry;
+
+	for (entry = global->entrylist; entry != NULL; entry = entry->next)
+	{
+		UINT32 totalsize = entry->typesize * entry->typecount;
+		const UINT8 *live = (const UINT8 *)entry->data;
+		UINT32 offs, chunk, i;
+
+		/* tracked entries that nobody wrote to cost nothing */
+		if (entry->tracked && !entry->dirty)
+		{
+			skip += totalsize;
+			ref += totalsize;
+			runlength = NULL;
+			continue;
+		}
+		entry->dirty = FALSE;
+
+		for (offs = 0; offs < totalsize; offs += chunk)
+		{
+			chunk = MIN(REWIND_CHUNK, totalsize - offs);
+
+			/* unchanged chunks just extend the skip */
+			if (memcmp(&live[offs], &ref[offs], chunk) == 0)
+			{
+				skip += chunk;
+				runlength = NULL;
+				continue;
+			}
+
+			/* start a new run if the previous chunk was unchanged */
+			if (runlength == NULL)
+			{
+				memcpy(out, &skip, sizeof(skip));
+				runlength = out + sizeof(skip);
+				out += sizeof(skip) + sizeof(run);
+				skip = run = 0;
+			}
+
+			for (i = 0; i < chunk; i++)
+			{
+				out[i] = live[offs + i] ^ ref[offs + i];
+				ref[offs + i] = live[offs + i];
+			}
+			out += chunk;
+			run += chunk;
+			memcpy(runlength, &run, sizeof(run));
+		}
+		ref += totalsize;
+	}
+	return out - dest;
+}
+
+
+/*-------------------------------------------------
+    rewind_decode - apply an encoded delta to the
+    reference, stepping it back one snapshot
+-------------------------------------------------*/
+
+static void rewind_decode(state_rewind *rewind, const UINT8 *src, UINT32 size)
+{
+	UINT8 *ref = rewind->reference + HEADER_SIZE;
+	const UINT8 *end = src + size;
+
+	while (src < end)
+	{
+		UINT32 skip, run, i;
+
+		memcpy(&skip, src, sizeof(skip));
+		memcpy(&run, src + sizeof(skip), sizeof(run));
+		src += sizeof(skip) + sizeof(run);
+
+		ref += skip;
+		for (i = 0; i < run; i++)
+			ref[i] ^= src[i];
+		ref += run;
+		src += run;
+	}
+}
+
+
+/*-------------------------------------------------
+    state_rewind_init - (re)allocate the rewind
+    history; a zero budget disables it
+-------------------------------------------------*/
+
+state_save_error state_rewind_init(running_machine *machine, UINT32 budget, UINT32 maxframes)
+{
+	state_private *global = machine->state_data;
+	state_rewind *rewind = global->rewind;
+	UINT32 scratchsize;
+	state_entry *entry;
+
+	/* free any previous history */
+	if (rewind != NULL)
+	{
+		auto_free(machine, rewind->slot);
+		auto_free(machine, rewind->ring);
+		auto_free(machine, rewind->scratch);
+		auto_free(machine, rewind->reference);
+		auto_free(machine, rewind);
+		global->rewind = NULL;
+	}
+
+	if (budget == 0 || maxframes == 0)
+		return STATERR_NONE;
+
+	/* if we have illegal registrations, return an error */
+	if (global->illegal_regs > 0)
+		return STATERR_ILLEGAL_REGISTRATIONS;
+
+	/* the layout must be final */
+	if (global->reg_allowed)
+		return STATERR_WRITE_ERROR;
+
+	/* worst case is a run header for every other chunk, plus two partial chunks per entry */
+	scratchsize = global->buffersize + 2 * sizeof(UINT32) * (global->buffersize / REWIND_CHUNK + 1);
+	for (entry = global->entrylist; entry != NULL; entry = entry->next)
+		scratchsize += 4 * sizeof(UINT32);
+
+	rewind = auto_alloc_clear(machine, state_rewind);
+	rewind->reference = auto_alloc_array(machine, UINT8, global->buffersize);
+	rewind->scratch = auto_alloc_array(machine, UINT8, scratchsize);
+	rewind->ring = auto_alloc_array(machine, UINT8, budget);
+	rewind->ringsize = budget;
+	rewind->slot = auto_alloc_array_clear(machine, state_rewind_slot, maxframes);
+	rewind->slots = maxframes;
+	global->rewind = rewind;
+
+	return STATERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    state_rewind_push - capture a snapshot as a
+    delta against the previous one, evicting the
+    oldest history to stay within the budget
+-------------------------------------------------*/
+
+state_save_error state_rewind_push(running_machine *machine)
+{
+	state_private *global = machine->state_data;
+	state_rewind *rewind = global->rewind;
+	state_rewind_slot *slot;
+	state_callback *func;
+	UINT32 size, offset;
+	int wrapped = FALSE;
+
+	if (rewind == NULL)
+		return STATERR_WRITE_ERROR;
+
+	/* the first snapshot just fills the reference */
+	if (!rewind->refvalid)
+	{
+		state_save_error err = state_save_write_buffer(machine, rewind->reference, global->buffersize);
+		rewind->refvalid = (err == STATERR_NONE);
+		return err;
+	}
+
+	/* call the pre-save functions */
+	for (func = global->prefunclist; func != NULL; func = func->next)
+		(*func->func.presave)(machine, func->param);
+
+	size = rewind_encode(global, rewind->scratch);
+
+	/* a delta bigger than the whole ring can't be kept; the history ends here */
+	if (size > rewind->ringsize)
+	{
+		rewind->count = rewind->first = rewind->head = 0;
+		return STATERR_NONE;
+	}
+
+	/* deltas are stored contiguously, wrapping to the start when they don't fit */
+	offset = rewind->head;
+	if (offset + size > rewind->ringsize)
+	{
+		offset = 0;
+		wrapped = TRUE;
+	}
+
+	/* evict the oldest deltas we are about to overwrite */
+	while (rewind->count > 0)
+	{
+		slot = &rewind->slot[rewind->first];
+		if (rewind->count < rewind->slots &&
+			(slot->offset >= offset + size || slot->offset + slot->size <= offset) &&
+			!(wrapped && slot->offset >= rewind->head))
+			break;
+
+		rewind->first = (rewind->first + 1) % rewind->slots;
+		rewind->count--;
+	}
+
+	/* store the new delta */
+	slot = &rewind->slot[(rewind->first + rewind->count) % rewind->slots];
+	slot->offset = offset;
+	slot->size = size;
+	memcpy(&rewind->ring[offset], rewind->scratch, size);
+	rewind->head = offset + size;
+	rewind->count++;
+
+	return STATERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    state_rewind_pop - restore the previous
+    snapshot; once the history is exhausted the
+    oldest snapshot is restored again
+-------------------------------------------------*/
+
+state_save_error state_rewind_pop(running_machine *machine)
+{
+	state_private *global = machine->state_data;
+	state_rewind *rewind = global->rewind;
+
+	if (rewind == NULL || !rewind->refvalid)
+		return STATERR_READ_ERROR;
+
+	/* step the reference back by the newest delta and reclaim its space */
+	if (rewind->count > 0)
+	{
+		state_rewind_slot *slot = &rewind->slot[(rewind->first + rewind->count - 1) % rewind->slots];
+
+		rewind_decode(rewind, &rewind->ring[slot->offset], slot->size);
+		rewind->head = slot->offset;
+		rewind->count--;
+	}
+
+	return state_save_read_buffer(machine, rewind->reference, global->buffersize);
+}
+
+
+/*-------------------------------------------------
+    state_rewind_count - return the number of
+    snapshots that can be stepped back
+-------------------------------------------------*/
+
+UINT32 state_rewind_count(running_machine *machine)
+{
+	state_rewind *rewind = machine->state_data->rewind;
+
+	return (rewind != NULL) ? rewind->count : 0;
+}
+
+
+
 /***************************************************************************
     DEBUGGING
 ***************************************************************************/
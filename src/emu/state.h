@@ -158,6 +158,9 @@ void state_save_register_memory(running_machine *machine, const char *module, co
 /* register a bitmap to be saved */
 void state_save_register_bitmap(running_machine *machine, const char *module, const char *tag, UINT32 index, const char *name, bitmap_t *val, const char *file, int line);
 
+/* return a flag to set on every write to a registered block, letting rewind skip it while clean */
+UINT8 *state_save_track_dirty(running_machine *machine, void *val);
+
 
 
 /* ----- callback function registraton ----- */
@@ -183,6 +186,35 @@ state_save_error state_save_read_file(running_machine *machine, mame_file *file)
 
 
 
+/* ----- in-memory save state processing ----- */
+
+/* return the size of an uncompressed in-memory save state (0 until registrations are closed) */
+UINT32 state_save_get_buffer_size(running_machine *machine);
+
+/* write the save state, uncompressed, into a caller-provided buffer */
+state_save_error state_save_write_buffer(running_machine *machine, void *buffer, UINT32 size);
+
+/* restore the save state from an uncompressed in-memory buffer */
+state_save_error state_save_read_buffer(running_machine *machine, const void *buffer, UINT32 size);
+
+
+
+/* ----- delta rewind history ----- */
+
+/* (re)allocate the rewind history with a fixed memory budget; a zero budget disables it */
+state_save_error state_rewind_init(running_machine *machine, UINT32 budget, UINT32 maxframes);
+
+/* capture a snapshot as a delta against the previous one */
+state_save_error state_rewind_push(running_machine *machine);
+
+/* restore the previous snapshot */
+state_save_error state_rewind_pop(running_machine *machine);
+
+/* return the number of snapshots that can be stepped back */
+UINT32 state_rewind_count(running_machine *machine);
+
+
+
 /* ----- debugging ----- */
 
 /* return an item with the given index */
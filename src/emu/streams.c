@@ -41,11 +41,30 @@
     These sample buffers can then be further resampled and passed to
     other streams, or output as desired.
 
+    With the sound_worker option, a device whose stream has no inputs can
+    let the engine generate it on a worker thread. Its register writes
+    are then queued with the sample they take effect at, and the worker
+    generates the stream up to each one before applying it. Anything on
+    the emulation thread that updates such a stream waits for the worker
+    first, so that the output matches what inline generation produces.
+
 ***************************************************************************/
 
 #include "emu.h"
+#include "emuopts.h"
 #include "streams.h"
 
+/* filter with the host vector unit; define STREAMS_NO_SIMD to force the scalar path */
+#if !defined(STREAMS_NO_SIMD)
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define STREAMS_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define STREAMS_NEON
+#endif
+#endif
+
 
 
 /***************************************************************************
@@ -58,6 +77,37 @@
 #define FRAC_ONE			(1 << FRAC_BITS)
 #define FRAC_MASK			(FRAC_ONE - 1)
 
+#define RESAMPLE_MAX_TAPS	(512)		/* longest filter, in source samples */
+
+#define DEFERRED_WRITES		(4096)		/* writes the worker may fall behind by; a power of 2 */
+#define DEFERRED_BATCH		(16)		/* writes gathered before the worker is woken */
+
+
+
+/***************************************************************************
+    RESAMPLER QUALITIES
+***************************************************************************/
+
+typedef struct _resample_params resample_params;
+struct _resample_params
+{
+	const char *		name;			/* option value */
+	int					halfwidth;		/* filter half width, in destination samples */
+	double				beta;			/* Kaiser window shape */
+	double				cutoff;			/* passband edge, as a fraction of the lower Nyquist rate */
+	int					phase_bits;		/* log2 of the number of filter phases */
+	int					interpolate;	/* blend between adjacent phases */
+};
+
+/* the cutoffs leave room for the transition band of each window, so that */
+/* nothing above the destination Nyquist rate folds back into the audio */
+static const resample_params resample_quality[STREAM_RESAMPLE_QUALITIES] =
+{
+	{ "fast",	0,	0.0,	0.0,	0,	FALSE },	/* linear interpolation */
+	{ "medium",	12,	6.0,	0.84,	9,	FALSE },	/* about 60dB of stopband */
+	{ "high",	24,	8.5,	0.88,	8,	TRUE }		/* about 85dB of stopband */
+};
+
 
 
 /***************************************************************************
@@ -66,6 +116,32 @@
 
 typedef struct _stream_input stream_input;
 typedef struct _stream_output stream_output;
+typedef struct _resample_filter resample_filter;
+typedef struct _deferred_write deferred_write;
+
+
+struct _resample_filter
+{
+	resample_filter *	next;			/* next filter in the list */
+	UINT32				in_rate;		/* source sample rate */
+	UINT32				out_rate;		/* destination sample rate */
+	int					taps;			/* coefficients per phase, a multiple of 4 */
+	int					phase_bits;		/* log2 of the number of phases */
+	int					interpolate;	/* blend between adjacent phases */
+	float *				coeffs;			/* one more phase than needed, for blending past the last */
+};
+
+
+struct _deferred_write
+{
+	sound_stream *		stream;			/* stream of the device written to */
+	stream_write_func	func;			/* function applying the write, or NULL to only update */
+	INT32				sampindex;		/* sample the write takes effect at */
+	int					update;			/* generate up to the write before applying it */
+	UINT32				offset;			/* parameters for the function */
+	UINT32				data;
+};
+
 
 struct _stream_input
 {
@@ -79,6 +155,7 @@ struct _stream_input
 	UINT32			bufalloc;		/* allocated size of output buffer, in samples */
 
 	/* resampling information */
+	resample_filter		*filter;		/* filter for the current pair of rates, or NULL for linear */
 	attoseconds_t		latency_attoseconds;	/* latency between this stream and the input stream */
 	INT16			gain;			/* gain to apply to this input */
 };
@@ -109,6 +186,7 @@ public:
 	/* general information */
 	UINT32			sample_rate;			/* sample rate of this stream */
 	UINT32			new_sample_rate;		/* newly-set sample rate for the stream */
+	int			deferred;			/* generated by the sound worker */
 
 	/* timing information */
 	attoseconds_t		attoseconds_per_sample;		/* number of attoseconds per sample */
@@ -146,6 +224,17 @@ struct _streams_private
 	int			stream_index;			/* index of the current stream */
 	attoseconds_t		update_attoseconds;		/* attoseconds between global updates */
 	attotime		last_update;			/* last update time */
+	int			resample_quality;		/* STREAM_RESAMPLE_* from the options */
+	resample_filter		*filter_list;			/* filters built so far, one per quality and pair of rates */
+
+	/* sound worker */
+	int			defer_writes;			/* sound_worker option */
+	osd_work_queue		*worker;			/* queue of the sound worker */
+	osd_work_item		*worker_item;			/* batch of writes being applied, or NULL */
+	deferred_write		*write;				/* ring of deferred writes */
+	UINT32			write_head;			/* count of writes queued */
+	UINT32			write_issued;			/* count of writes handed to the worker */
+	UINT32			write_done;			/* count of writes applied */
 };
 
 
@@ -153,12 +242,20 @@ struct _streams_private
     FUNCTION PROTOTYPES
 ***************************************************************************/
 
+static STATE_PRESAVE( stream_presave );
 static STATE_POSTLOAD( stream_postload );
+static void streams_exit(running_machine &machine);
 static void allocate_resample_buffers(running_machine *machine, sound_stream *stream);
 static void allocate_output_buffers(running_machine *machine, sound_stream *stream);
 static void recompute_sample_rate_data(running_machine *machine, sound_stream *stream);
 static void generate_samples(sound_stream *stream, int samples);
 static stream_sample_t *generate_resampled_data(stream_input *input, UINT32 numsamples);
+static resample_filter *find_resample_filter(running_machine *machine, int quality, UINT32 in_rate, UINT32 out_rate);
+static void resample_span(const resample_filter *filter, stream_sample_t *dest, const stream_sample_t *source, UINT32 basefrac, UINT32 step, UINT32 numsamples, INT32 gain);
+static void queue_deferred_write(sound_stream *stream, stream_write_func func, UINT32 offset, UINT32 data, int update);
+static void *deferred_write_callback(void *param, int threadid);
+static void apply_deferred_writes(streams_private *strdata, UINT32 first, UINT32 last);
+static void finish_deferred_writes(streams_private *strdata);
 
 
 /***************************************************************************
@@ -202,6 +299,7 @@ INLINE INT32 time_to_sampindex(const streams_private *strdata, const sound_strea
 
 void streams_init(running_machine *machine)
 {
+	const char *quality = options_get_string(machine->options(), OPTION_RESAMPLER);
 	streams_private *strdata;
 
 	/* allocate memory for our private data */
@@ -211,16 +309,41 @@ void streams_init(running_machine *machine)
 	strdata->stream_tailptr = &strdata->stream_head;
 	strdata->update_attoseconds = STREAMS_UPDATE_ATTOTIME.attoseconds;
 
+	/* pick the resampler */
+	strdata->resample_quality = STREAM_RESAMPLE_MEDIUM;
+	for (int index = 0; index < STREAM_RESAMPLE_QUALITIES; index++)
+		if (quality != NULL && strcmp(quality, resample_quality[index].name) == 0)
+			strdata->resample_quality = index;
+
+	/* the worker is only started once a stream can use it */
+	strdata->defer_writes = options_get_bool(machine->options(), OPTION_SOUND_WORKER);
+
 	/* set the global pointer */
 	machine->streams_data = strdata;
 
 	/* register global states */
 	state_save_register_global(machine, strdata->last_update.seconds);
 	state_save_register_global(machine, strdata->last_update.attoseconds);
+	state_save_register_presave(machine, stream_presave, strdata);
 	state_save_register_postload(machine, stream_postload, strdata);
 }
 
 
+/*-------------------------------------------------
+    streams_exit - stop the sound worker before
+    the devices it writes to are stopped
+-------------------------------------------------*/
+
+static void streams_exit(running_machine &machine)
+{
+	streams_private *strdata = machine.streams_data;
+
+	finish_deferred_writes(strdata);
+	osd_work_queue_free(strdata->worker);
+	strdata->worker = NULL;
+}
+
+
 /*-------------------------------------------------
     streams_update - update all the streams
     periodically
@@ -308,11 +431,31 @@ void streams_update(running_machine *machine)
 			/* clear out the buffer */
 			for (outputnum = 0; outputnum < stream->outputs; outputnum++)
 				memset(stream->output[outputnum].buffer, 0, stream->max_samples_per_update * sizeof(stream->output[outputnum].buffer[0]));
+
+			/* the streams we feed need a filter and latency for the new rate */
+			for (sound_stream *consumer = strdata->stream_head; consumer != NULL; consumer = consumer->next)
+				for (int inputnum = 0; inputnum < consumer->inputs; inputnum++)
+					if (consumer->input[inputnum].source != NULL && consumer->input[inputnum].source->owner == stream)
+					{
+						recompute_sample_rate_data(machine, consumer);
+						break;
+					}
 		}
 	}
 }
 
 
+/*-------------------------------------------------
+    streams_sync - wait for the sound worker to
+    apply every deferred write
+-------------------------------------------------*/
+
+void streams_sync(running_machine *machine)
+{
+	finish_deferred_writes(machine->streams_data);
+}
+
+
 /***************************************************************************
     STREAM CONFIGURATION AND SETUP
 ***************************************************************************/
@@ -495,6 +638,10 @@ void stream_update(sound_stream *stream)
 	streams_private *strdata = machine->streams_data;
 	INT32 update_sampindex = time_to_sampindex(strdata, stream, timer_get_time(machine));
 
+	/* writes already queued come first */
+	if (stream->deferred)
+		finish_deferred_writes(strdata);
+
 	/* generate samples to get us up to the appropriate time */
 	assert(stream->output_sampindex - stream->output_base_sampindex >= 0);
 	assert(update_sampindex - stream->output_base_sampindex <= stream->output_bufalloc);
@@ -525,6 +672,107 @@ const stream_sample_t *stream_get_output_since_last_update(sound_stream *stream,
 }
 
 
+
+/***************************************************************************
+    DEFERRED REGISTER WRITES
+***************************************************************************/
+
+/*-------------------------------------------------
+    stream_allow_deferred_writes - let the sound
+    worker generate a stream; only the device's
+    own writes may change what it generates
+-------------------------------------------------*/
+
+int stream_allow_deferred_writes(sound_stream *stream)
+{
+	running_machine *machine = stream->device->machine;
+	streams_private *strdata = machine->streams_data;
+
+	/* the worker can't pull inputs that are generated on this thread */
+	if (!strdata->defer_writes || stream->inputs > 0)
+		return FALSE;
+
+	if (strdata->worker == NULL)
+	{
+		strdata->worker = osd_work_queue_alloc(0);
+		if (strdata->worker == NULL)
+		{
+			strdata->defer_writes = FALSE;
+			return FALSE;
+		}
+		strdata->write = auto_alloc_array(machine, deferred_write, DEFERRED_WRITES);
+		machine->add_notifier(MACHINE_NOTIFY_EXIT, streams_exit);
+	}
+
+	stream->deferred = TRUE;
+	return TRUE;
+}
+
+
+/*-------------------------------------------------
+    stream_write - update a stream to the current
+    time and apply a write to its device, or have
+    the sound worker do both
+-------------------------------------------------*/
+
+void stream_write(sound_stream *stream, stream_write_func func, UINT32 offset, UINT32 data)
+{
+	if (!stream->deferred)
+	{
+		stream_update(stream);
+		if (func != NULL)
+			(*func)(stream->device, stream->param, offset, data);
+		return;
+	}
+
+	queue_deferred_write(stream, func, offset, data, TRUE);
+}
+
+
+/*-------------------------------------------------
+    stream_latch - apply a write that the stream
+    only hears from its next update, such as an
+    address latch; the sound worker applies it in
+    order with the other writes
+-------------------------------------------------*/
+
+void stream_latch(sound_stream *stream, stream_write_func func, UINT32 offset, UINT32 data)
+{
+	if (!stream->deferred)
+	{
+		(*func)(stream->device, stream->param, offset, data);
+		return;
+	}
+
+	queue_deferred_write(stream, func, offset, data, FALSE);
+}
+
+
+/*-------------------------------------------------
+    stream_mark_update - update a stream to the
+    current time, or have the sound worker do it
+    before the next write
+-------------------------------------------------*/
+
+void stream_mark_update(sound_stream *stream)
+{
+	stream_write(stream, NULL, 0, 0);
+}
+
+
+/*-------------------------------------------------
+    stream_sync - apply every write queued for a
+    stream, generating only the samples before
+    each of them
+-------------------------------------------------*/
+
+void stream_sync(sound_stream *stream)
+{
+	if (stream->deferred)
+		finish_deferred_writes(stream->device->machine->streams_data);
+}
+
+
 /***************************************************************************
     STREAM TIMING
 ***************************************************************************/
@@ -674,6 +922,17 @@ void stream_set_output_gain(sound_stream *stream, int output, float gain)
     STREAM BUFFER MAINTENANCE
 ***************************************************************************/
 
+/*-------------------------------------------------
+    stream_presave - save callback; the devices
+    saved must not still be written to
+-------------------------------------------------*/
+
+static STATE_PRESAVE( stream_presave )
+{
+	finish_deferred_writes(reinterpret_cast<streams_private *>(param));
+}
+
+
 /*-------------------------------------------------
     stream_postload - save/restore callback
 -------------------------------------------------*/
@@ -750,7 +1009,7 @@ static void allocate_output_buffers(running_machine *machine, sound_stream *stre
 		for (int outputnum = 0; outputnum < stream->outputs; outputnum++)
 		{
 			stream_output *output = &stream->output[outputnum];
-			stream_sample_t *newbuffer = auto_alloc_array(machine, stream_sample_t, stream->output_bufalloc);
+			stream_sample_t *newbuffer = auto_alloc_array_clear(machine, stream_sample_t, stream->output_bufalloc);
 			memcpy(newbuffer, output->buffer, oldsize * sizeof(stream_sample_t));
 			auto_free(machine, output->buffer);
 			output->buffer = newbuffer;
@@ -792,16 +1051,24 @@ static void recompute_sample_rate_data(running_machine *machine, sound_stream *s
 			/* okay, we have a new sample rate; recompute the latency to be the maximum
 			   sample period between us and our input */
 			latency = MAX(new_attosecs_per_sample, stream->attoseconds_per_sample);
-
-			/* if the input stream's sample rate is lower, we will use linear interpolation */
-			/* this requires an extra sample from the source */
-			if (input_stream->sample_rate < stream->sample_rate)
-				latency += new_attosecs_per_sample;
+			input->filter = NULL;
 
 			/* if our sample rates match exactly, we don't need any latency */
-			else if (input_stream->sample_rate == stream->sample_rate)
+			if (input_stream->sample_rate == stream->sample_rate)
 				latency = 0;
 
+			/* a filter reaches half its length past the current sample */
+			else if (strdata->resample_quality != STREAM_RESAMPLE_FAST)
+			{
+				input->filter = find_resample_filter(machine, strdata->resample_quality, input_stream->sample_rate, stream->sample_rate);
+				latency += (input->filter->taps / 2) * new_attosecs_per_sample;
+			}
+
+			/* if the input stream's sample rate is lower, linear interpolation */
+			/* requires an extra sample from the source */
+			else if (input_stream->sample_rate < stream->sample_rate)
+				latency += new_attosecs_per_sample;
+
 			/* we generally don't want to tweak the latency, so we just keep the greatest
 			   one we've computed thus far */
 			input->latency_attoseconds = MAX(input->latency_attoseconds, latency);
@@ -853,6 +1120,123 @@ static void generate_samples(sound_stream *stream, int samples)
 }
 
 
+/*-------------------------------------------------
+    queue_deferred_write - queue a write for the
+    sound worker, handing it a batch once enough
+    have gathered
+-------------------------------------------------*/
+
+static void queue_deferred_write(sound_stream *stream, stream_write_func func, UINT32 offset, UINT32 data, int update)
+{
+	running_machine *machine = stream->device->machine;
+	streams_private *strdata = machine->streams_data;
+	INT32 sampindex = time_to_sampindex(strdata, stream, timer_get_time(machine));
+	deferred_write *write;
+
+	/* an update not yet handed over can simply be moved up to now */
+	if (func == NULL && strdata->write_head != strdata->write_issued)
+	{
+		write = &strdata->write[(strdata->write_head - 1) & (DEFERRED_WRITES - 1)];
+		if (write->stream == stream && write->func == NULL)
+		{
+			write->sampindex = sampindex;
+			return;
+		}
+	}
+
+	/* if the worker is a whole ring behind, catch up */
+	if (strdata->write_head - strdata->write_done == DEFERRED_WRITES)
+		finish_deferred_writes(strdata);
+
+	write = &strdata->write[strdata->write_head++ & (DEFERRED_WRITES - 1)];
+	write->stream = stream;
+	write->func = func;
+	write->sampindex = sampindex;
+	write->update = update;
+	write->offset = offset;
+	write->data = data;
+
+	/* collect a finished batch */
+	if (strdata->worker_item != NULL && osd_work_item_wait(strdata->worker_item, 0))
+	{
+		osd_work_item_release(strdata->worker_item);
+		strdata->worker_item = NULL;
+		strdata->write_done = strdata->write_issued;
+	}
+
+	/* and hand over the next once enough has gathered */
+	if (strdata->worker_item == NULL && strdata->write_head - strdata->write_issued >= DEFERRED_BATCH)
+	{
+		strdata->write_issued = strdata->write_head;
+		strdata->worker_item = osd_work_item_queue(strdata->worker, deferred_write_callback, strdata, 0);
+		if (strdata->worker_item == NULL)
+			finish_deferred_writes(strdata);
+	}
+}
+
+
+/*-------------------------------------------------
+    deferred_write_callback - apply a batch of
+    writes on the sound worker
+-------------------------------------------------*/
+
+static void *deferred_write_callback(void *param, int threadid)
+{
+	streams_private *strdata = (streams_private *)param;
+
+	/* the emulation thread leaves these alone until we are done */
+	apply_deferred_writes(strdata, strdata->write_done, strdata->write_issued);
+	return NULL;
+}
+
+
+/*-------------------------------------------------
+    apply_deferred_writes - generate each stream
+    up to its writes and apply them
+-------------------------------------------------*/
+
+static void apply_deferred_writes(streams_private *strdata, UINT32 first, UINT32 last)
+{
+	for (UINT32 index = first; index != last; index++)
+	{
+		const deferred_write *write = &strdata->write[index & (DEFERRED_WRITES - 1)];
+		sound_stream *stream = write->stream;
+
+		/* exactly what stream_update would have done at the time of the write */
+		if (write->update)
+		{
+			generate_samples(stream, write->sampindex - stream->output_sampindex);
+			stream->output_sampindex = write->sampindex;
+		}
+
+		if (write->func != NULL)
+			(*write->func)(stream->device, stream->param, write->offset, write->data);
+	}
+}
+
+
+/*-------------------------------------------------
+    finish_deferred_writes - wait for the batch
+    on the sound worker and apply the rest here
+-------------------------------------------------*/
+
+static void finish_deferred_writes(streams_private *strdata)
+{
+	if (strdata->worker_item != NULL)
+	{
+		while (!osd_work_item_wait(strdata->worker_item, osd_ticks_per_second()))
+			;
+		osd_work_item_release(strdata->worker_item);
+		strdata->worker_item = NULL;
+		strdata->write_done = strdata->write_issued;
+	}
+
+	UINT32 first = strdata->write_done;
+	strdata->write_done = strdata->write_issued = strdata->write_head;
+	apply_deferred_writes(strdata, first, strdata->write_head);
+}
+
+
 /*-------------------------------------------------
     generate_resampled_data - generate the
     resample buffer for a given input
@@ -902,81 +1286,248 @@ static stream_sample_t *generate_resampled_data(stream_input *input, UINT32 nums
 	/* compute the stepping fraction */
 	UINT32 step = ((UINT64)input_stream->sample_rate << FRAC_BITS) / stream->sample_rate;
 
-	/* if we have equal sample rates, we just need to copy */
+	/* if we have equal sample rates, we just need to copy, or not even that at unity gain */
 	if (step == FRAC_ONE)
 	{
+		if (gain == 0x100)
+			return source;
+
 		while (numsamples--)
 		{
 			/* compute the sample */
 			sample = *source++;
 			*dest++ = (sample * gain) >> 8;
 		}
+		return input->resample;
 	}
 
-	/* input is undersampled: point sample except where our sample period covers a boundary */
-	else if (step < FRAC_ONE)
+	/* the filter was picked for the rates when the latency was last computed */
+	streams_private *strdata = stream->device->machine->streams_data;
+	if (strdata->resample_quality != STREAM_RESAMPLE_FAST && (input->filter == NULL || input->filter->in_rate != input_stream->sample_rate || input->filter->out_rate != stream->sample_rate))
+		input->filter = find_resample_filter(stream->device->machine, strdata->resample_quality, input_stream->sample_rate, stream->sample_rate);
+	assert(input->filter == NULL || basesample - (input->filter->taps / 2 - 1) >= input_stream->output_base_sampindex);
+
+	resample_span(input->filter, dest, source, basefrac, step, numsamples, gain);
+	return input->resample;
+}
+
+
+
+/***************************************************************************
+    RESAMPLING
+***************************************************************************/
+
+/*-------------------------------------------------
+    bessel_i0 - zeroth order modified Bessel
+    function of the first kind, for the Kaiser
+    window
+-------------------------------------------------*/
+
+static double bessel_i0(double x)
+{
+	double sum = 1.0, term = 1.0;
+
+	for (int k = 1; k < 64 && term > sum * 1e-12; k++)
 	{
-		while (numsamples != 0)
-		{
-			int nextfrac, startfrac, endfrac;
+		double half = x / (2.0 * k);
+		term *= half * half;
+		sum += term;
+	}
+	return sum;
+}
 
-			/* fill in with point samples until we hit a boundary */
-			while ((nextfrac = basefrac + step) < FRAC_ONE && numsamples--)
-			{
-				*dest++ = (source[0] * gain) >> 8;
-				basefrac = nextfrac;
-			}
 
-			/* if we're done, we're done */
-			if ((INT32)numsamples-- < 0)
-				break;
+/*-------------------------------------------------
+    find_resample_filter - return the polyphase
+    windowed sinc filter for a pair of rates,
+    building its coefficients the first time
+-------------------------------------------------*/
 
-			/* compute starting and ending fractional positions */
-			startfrac = basefrac >> (FRAC_BITS - 12);
-			endfrac = nextfrac >> (FRAC_BITS - 12);
+static resample_filter *find_resample_filter(running_machine *machine, int quality, UINT32 in_rate, UINT32 out_rate)
+{
+	streams_private *strdata = machine->streams_data;
+	const resample_params *params = &resample_quality[quality];
+	resample_filter *filter;
+
+	/* filters are shared by every input converting between the same rates */
+	for (filter = strdata->filter_list; filter != NULL; filter = filter->next)
+		if (filter->in_rate == in_rate && filter->out_rate == out_rate && filter->phase_bits == params->phase_bits && filter->interpolate == params->interpolate)
+			return filter;
+
+	/* when decimating, the cutoff drops to the destination rate and the filter widens to match */
+	double ratio = MIN((double)out_rate / (double)in_rate, 1.0);
+	double cutoff = params->cutoff * ratio;
+	int halfwidth = (int)ceil(params->halfwidth / ratio);
+
+	/* very high source rates get a shorter window rather than an unbounded one */
+	halfwidth = MIN((halfwidth + 1) & ~1, RESAMPLE_MAX_TAPS / 2);
+
+	filter = auto_alloc_clear(machine, resample_filter);
+	filter->in_rate = in_rate;
+	filter->out_rate = out_rate;
+	filter->taps = 2 * halfwidth;
+	filter->phase_bits = params->phase_bits;
+	filter->interpolate = params->interpolate;
+
+	int phases = 1 << filter->phase_bits;
+	filter->coeffs = auto_alloc_array(machine, float, (phases + 1) * filter->taps);
+
+	/* phase p sits p/phases of a sample past the source sample at tap halfwidth-1 */
+	double scale = 1.0 / bessel_i0(params->beta);
+	for (int phase = 0; phase <= phases; phase++)
+	{
+		float *coeffs = &filter->coeffs[phase * filter->taps];
+		double sum = 0.0;
 
-			/* blend between the two samples accordingly */
-			sample = (source[0] * (0x1000 - startfrac) + source[1] * (endfrac - 0x1000)) / (endfrac - startfrac);
-			*dest++ = (sample * gain) >> 8;
+		for (int tap = 0; tap < filter->taps; tap++)
+		{
+			double t = (double)(tap - (halfwidth - 1)) - (double)phase / (double)phases;
+			double x = t / (double)halfwidth;
+			double window = (x > -1.0 && x < 1.0) ? bessel_i0(params->beta * sqrt(1.0 - x * x)) * scale : 0.0;
+			double sinc = (t == 0.0) ? cutoff : sin(M_PI * cutoff * t) / (M_PI * t);
 
-			/* advance */
-			basefrac = nextfrac & FRAC_MASK;
-			source++;
+			coeffs[tap] = sinc * window;
+			sum += coeffs[tap];
 		}
+
+		/* unity gain at DC for every phase */
+		for (int tap = 0; tap < filter->taps; tap++)
+			coeffs[tap] /= sum;
 	}
 
-	/* input is oversampled: sum the energy */
-	else
-	{
-		/* use 8 bits to allow some extra headroom */
-		int smallstep = step >> (FRAC_BITS - 8);
+	filter->next = strdata->filter_list;
+	strdata->filter_list = filter;
+	return filter;
+}
 
-		while (numsamples--)
+
+/*-------------------------------------------------
+    filter_sample - apply one phase of a filter to
+    the source samples under it
+-------------------------------------------------*/
+
+INLINE float filter_sample(const stream_sample_t *source, const float *coeffs, int taps)
+{
+#if defined(STREAMS_SSE2)
+	__m128 sum = _mm_setzero_ps();
+
+	for (int tap = 0; tap < taps; tap += 4)
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)&source[tap])), _mm_loadu_ps(&coeffs[tap])));
+	sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+	sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+	return _mm_cvtss_f32(sum);
+#elif defined(STREAMS_NEON)
+	float32x4_t sum = vdupq_n_f32(0.0f);
+
+	for (int tap = 0; tap < taps; tap += 4)
+		sum = vmlaq_f32(sum, vcvtq_f32_s32(vld1q_s32(&source[tap])), vld1q_f32(&coeffs[tap]));
+	float32x2_t half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+	return vget_lane_f32(vpadd_f32(half, half), 0);
+#else
+	float sum = 0.0f;
+
+	for (int tap = 0; tap < taps; tap++)
+		sum += (float)source[tap] * coeffs[tap];
+	return sum;
+#endif
+}
+
+
+/*-------------------------------------------------
+    resample_span - convert a span of samples
+    between rates, with a filter or with linear
+    interpolation when there is none
+-------------------------------------------------*/
+
+static void resample_span(const resample_filter *filter, stream_sample_t *dest, const stream_sample_t *source, UINT32 basefrac, UINT32 step, UINT32 numsamples, INT32 gain)
+{
+	stream_sample_t sample;
+
+	/* no filter: interpolate between the two source samples around each position */
+	if (filter == NULL)
+	{
+		while (numsamples != 0)
 		{
-			int remainder = smallstep;
-			int tpos = 0;
-			int scale;
+			INT32 base = source[0];
+			INT32 delta = source[1] - source[0];
 
-			/* compute the sample */
-			scale = (FRAC_ONE - basefrac) >> (FRAC_BITS - 8);
-			sample = source[tpos++] * scale;
-			remainder -= scale;
-			while (remainder > 0x100)
+			/* every destination sample that falls between these two source samples */
+			do
 			{
-				sample += source[tpos++] * 0x100;
-				remainder -= 0x100;
-			}
-			sample += source[tpos] * remainder;
-			sample /= smallstep;
-
-			*dest++ = (sample * gain) >> 8;
+				sample = base + (INT32)(((INT64)delta * (INT32)(basefrac >> (FRAC_BITS - 12))) >> 12);
+				*dest++ = (sample * gain) >> 8;
+				basefrac += step;
+			} while (--numsamples != 0 && basefrac < FRAC_ONE);
 
 			/* advance */
-			basefrac += step;
 			source += basefrac >> FRAC_BITS;
 			basefrac &= FRAC_MASK;
 		}
+		return;
 	}
 
-	return input->resample;
+	/* the filter is centered between taps halfwidth-1 and halfwidth */
+	int shift = FRAC_BITS - filter->phase_bits;
+	float blendscale = 1.0f / (float)(1 << shift);
+	source -= filter->taps / 2 - 1;
+
+	while (numsamples--)
+	{
+		const float *coeffs = &filter->coeffs[(basefrac >> shift) * filter->taps];
+		float value = filter_sample(source, coeffs, filter->taps);
+
+		/* blend towards the next phase by the remaining fraction */
+		if (filter->interpolate)
+		{
+			float next = filter_sample(source, coeffs + filter->taps, filter->taps);
+			value += (next - value) * (float)(basefrac & ((1 << shift) - 1)) * blendscale;
+		}
+
+		sample = (stream_sample_t)((value < 0.0f) ? value - 0.5f : value + 0.5f);
+		*dest++ = (sample * gain) >> 8;
+
+		/* advance */
+		basefrac += step;
+		source += basefrac >> FRAC_BITS;
+		basefrac &= FRAC_MASK;
+	}
+}
+
+
+/*-------------------------------------------------
+    stream_resample_benchmark - time converting
+    one second of noise between two rates at a
+    given quality; returns the best of a few runs
+    in osd ticks
+-------------------------------------------------*/
+
+osd_ticks_t stream_resample_benchmark(running_machine *machine, int quality, int in_rate, int out_rate)
+{
+	const resample_filter *filter = (quality != STREAM_RESAMPLE_FAST) ? find_resample_filter(machine, quality, in_rate, out_rate) : NULL;
+	UINT32 step = ((UINT64)in_rate << FRAC_BITS) / out_rate;
+	int padding = RESAMPLE_MAX_TAPS;
+	stream_sample_t *source = global_alloc_array(stream_sample_t, in_rate + 2 * padding);
+	stream_sample_t *dest = global_alloc_array(stream_sample_t, out_rate);
+	osd_ticks_t best = 0;
+	UINT32 seed = 1;
+
+	/* a private generator, so that the machine's random sequence is left alone */
+	for (int index = 0; index < in_rate + 2 * padding; index++)
+	{
+		seed = seed * 1103515245 + 12345;
+		source[index] = (stream_sample_t)((seed >> 16) & 0xffff) - 0x8000;
+	}
+
+	for (int run = 0; run < 5; run++)
+	{
+		osd_ticks_t start = osd_ticks();
+		resample_span(filter, dest, source + padding, 0, step, out_rate, 0x100);
+		osd_ticks_t elapsed = osd_ticks() - start;
+		if (run == 0 || elapsed < best)
+			best = elapsed;
+	}
+
+	global_free(dest);
+	global_free(source);
+	return best;
 }
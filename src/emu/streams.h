@@ -21,6 +21,15 @@
 #define STREAMS_UPDATE_FREQUENCY	(50)
 #define STREAMS_UPDATE_ATTOTIME		ATTOTIME_IN_HZ(STREAMS_UPDATE_FREQUENCY)
 
+/* resampler qualities, as picked by the resampler option */
+enum
+{
+	STREAM_RESAMPLE_FAST,			/* linear interpolation */
+	STREAM_RESAMPLE_MEDIUM,			/* short windowed sinc */
+	STREAM_RESAMPLE_HIGH,			/* long windowed sinc, interpolated between phases */
+	STREAM_RESAMPLE_QUALITIES
+};
+
 
 
 /***************************************************************************
@@ -33,6 +42,9 @@ typedef void (*stream_update_func)(device_t *device, void *param, stream_sample_
 
 #define STREAM_UPDATE(name) void name(device_t *device, void *param, stream_sample_t **inputs, stream_sample_t **outputs, int samples)
 
+typedef void (*stream_write_func)(device_t *device, void *param, UINT32 offset, UINT32 data);
+#define STREAM_WRITE(name) void name(device_t *device, void *param, UINT32 offset, UINT32 data)
+
 
 
 /***************************************************************************
@@ -48,6 +60,9 @@ void streams_init(running_machine *machine);
 /* update all the streams periodically */
 void streams_update(running_machine *machine);
 
+/* wait for the sound worker to apply every deferred write */
+void streams_sync(running_machine *machine);
+
 
 
 /* ----- stream configuration and setup ----- */
@@ -72,6 +87,25 @@ const stream_sample_t *stream_get_output_since_last_update(sound_stream *stream,
 
 
 
+/* ----- deferred register writes ----- */
+
+/* let the sound worker generate a stream that has no inputs; returns TRUE if it will */
+int stream_allow_deferred_writes(sound_stream *stream);
+
+/* update a stream to the current time and apply a write to its device, or queue both for the sound worker */
+void stream_write(sound_stream *stream, stream_write_func func, UINT32 offset, UINT32 data);
+
+/* apply a write that is only heard from the next update, or queue it in order with the others */
+void stream_latch(sound_stream *stream, stream_write_func func, UINT32 offset, UINT32 data);
+
+/* update a stream to the current time, or have the sound worker do it before the next write */
+void stream_mark_update(sound_stream *stream);
+
+/* apply every write queued for a stream without generating any further samples */
+void stream_sync(sound_stream *stream);
+
+
+
 /* ----- stream timing ----- */
 
 /* return the currently set sample rate on a given stream */
@@ -108,5 +142,8 @@ void stream_set_input_gain(sound_stream *stream, int input, float gain);
 /* set the output gain on a given stream */
 void stream_set_output_gain(sound_stream *stream, int output, float gain);
 
+/* time converting one second of audio between two rates at a given quality, in osd ticks */
+osd_ticks_t stream_resample_benchmark(running_machine *machine, int quality, int in_rate, int out_rate);
+
 
 #endif
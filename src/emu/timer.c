@@ -49,8 +49,10 @@ class emu_timer
 {
 public:
 	running_machine *		machine;		/* pointer to the owning machine */
-	emu_timer *				next;			/* next timer in order in the list */
-	emu_timer *				prev;			/* previous timer in order in the list */
+	emu_timer *				next;			/* next timer in the free list */
+	int						index;			/* position in the active heap */
+	attotime				order;			/* time the timer is ordered by; never if it was disabled */
+	UINT64					sequence;		/* insertion count, which orders timers due at the same time */
 	timer_fired_func		callback;		/* callback function */
 	INT32					param;			/* integer parameter */
 	void *					ptr;			/* pointer parameter */
@@ -81,9 +83,11 @@ struct _quantum_slot
 /* In mame.h: typedef struct _timer_private timer_private; */
 struct _timer_private
 {
-	/* list of active timers */
+	/* active timers, in a binary heap with the next to fire at the top */
 	emu_timer				timers[MAX_TIMERS]; /* actual timers */
-	emu_timer *				activelist;			/* head of the active list */
+	emu_timer *				active[MAX_TIMERS]; /* the heap */
+	int						active_count;		/* number of active timers */
+	UINT64					sequence;			/* insertions so far */
 	emu_timer *				freelist;			/* head of the free list */
 	emu_timer *				freelist_tail;		/* tail of the free list */
 
@@ -164,100 +168,107 @@ INLINE emu_timer *timer_new(running_machine *machine)
 }
 
 
+/*-------------------------------------------------
+    timer_before - return TRUE if a timer comes
+    before another in the active heap
+-------------------------------------------------*/
+
+INLINE int timer_before(const emu_timer *timer, const emu_timer *other)
+{
+	int result = attotime_compare(timer->order, other->order);
+	return (result != 0) ? (result < 0) : (timer->sequence < other->sequence);
+}
+
+
+/*-------------------------------------------------
+    timer_heap_place - move a timer to its place
+    in the active heap, starting at a given index
+-------------------------------------------------*/
+
+INLINE void timer_heap_place(timer_private *global, emu_timer *timer, int index)
+{
+	/* first up, past any parent that comes later */
+	while (index > 0 && timer_before(timer, global->active[(index - 1) / 2]))
+	{
+		emu_timer *parent = global->active[(index - 1) / 2];
+		global->active[index] = parent;
+		parent->index = index;
+		index = (index - 1) / 2;
+	}
+
+	/* then down, past any child that comes earlier */
+	for (;;)
+	{
+		int child = 2 * index + 1;
+		if (child >= global->active_count)
+			break;
+		if (child + 1 < global->active_count && timer_before(global->active[child + 1], global->active[child]))
+			child++;
+		if (!timer_before(global->active[child], timer))
+			break;
+		global->active[index] = global->active[child];
+		global->active[index]->index = index;
+		index = child;
+	}
+
+	global->active[index] = timer;
+	timer->index = index;
+}
+
+
 /*-------------------------------------------------
     timer_list_insert - insert a new timer into
-    the list at the appropriate location
+    the active heap
 -------------------------------------------------*/
 
 INLINE void timer_list_insert(emu_timer *timer)
 {
-	attotime expire = timer->enabled ? timer->expire : attotime_never;
 	timer_private *global = timer->machine->timer_data;
-	emu_timer *t, *lt = NULL;
 
 	/* sanity checks for the debug build */
 	#ifdef MAME_DEBUG
 	{
-		int tnum = 0;
-
-		/* loop over the timer list */
-		for (t = global->activelist; t; t = t->next, tnum++)
-		{
-			if (t == timer)
-				fatalerror("This timer is already inserted in the list!");
-			if (tnum == MAX_TIMERS-1)
-				fatalerror("Timer list is full!");
-		}
+		if (timer->index < global->active_count && global->active[timer->index] == timer)
+			fatalerror("This timer is already inserted in the list!");
+		if (global->active_count == MAX_TIMERS)
+			fatalerror("Timer list is full!");
 	}
 	#endif
 
-	/* loop over the timer list */
-	for (t = global->activelist; t != NULL; lt = t, t = t->next)
-	{
-		/* if the current list entry expires after us, we should be inserted before it */
-		if (attotime_compare(t->expire, expire) > 0)
-		{
-			/* link the new guy in before the current list entry */
-			timer->prev = t->prev;
-			timer->next = t;
+	/* a timer goes after every one due no later than it, as it did in the sorted list */
+	timer->order = timer->enabled ? timer->expire : attotime_never;
+	timer->sequence = global->sequence++;
+	timer_heap_place(global, timer, global->active_count++);
 
-			if (t->prev != NULL)
-				t->prev->next = timer;
-			else
-			{
-				global->activelist = timer;
-				global->exec.nextfire = timer->expire;
-			}
-			t->prev = timer;
-			return;
-		}
-	}
-
-	/* need to insert after the last one */
-	if (lt != NULL)
-		lt->next = timer;
-	else
-	{
-		global->activelist = timer;
-		global->exec.nextfire = timer->expire;
-	}
-	timer->prev = lt;
-	timer->next = NULL;
+	global->exec.nextfire = global->active[0]->expire;
 }
 
 
 /*-------------------------------------------------
     timer_list_remove - remove a timer from the
-    linked list
+    active heap
 -------------------------------------------------*/
 
 INLINE void timer_list_remove(emu_timer *timer)
 {
 	timer_private *global = timer->machine->timer_data;
+	int index = timer->index;
 
 	/* sanity checks for the debug build */
 	#ifdef MAME_DEBUG
 	{
-		emu_timer *t;
-
-		/* loop over the timer list */
-		for (t = global->activelist; t && t != timer; t = t->next) ;
-		if (t == NULL)
+		if (index >= global->active_count || global->active[index] != timer)
 			fatalerror("timer (%s from %s:%d) not found in list", timer->func, timer->file, timer->line);
 	}
 	#endif
 
-	/* remove it from the list */
-	if (timer->prev != NULL)
-		timer->prev->next = timer->next;
-	else
-	{
-		global->activelist = timer->next;
-		if (global->activelist != NULL)
-			global->exec.nextfire = global->activelist->expire;
-	}
-	if (timer->next != NULL)
-		timer->next->prev = timer->prev;
+	/* fill the hole with the last timer */
+	if (--global->active_count != index)
+		timer_heap_place(global, global->active[global->active_count], index);
+	timer->index = MAX_TIMERS;
+
+	if (global->active_count != 0)
+		global->exec.nextfire = global->active[0]->expire;
 }
 
 
@@ -291,12 +302,14 @@ void timer_init(running_machine *machine)
 	state_save_register_postload(machine, timer_postload, NULL);
 
 	/* initialize the lists */
-	global->activelist = NULL;
+	global->active_count = 0;
 	global->freelist = &global->timers[0];
 	for (i = 0; i < MAX_TIMERS-1; i++)
 		global->timers[i].next = &global->timers[i+1];
 	global->timers[MAX_TIMERS-1].next = NULL;
 	global->freelist_tail = &global->timers[MAX_TIMERS-1];
+	for (i = 0; i < MAX_TIMERS; i++)
+		global->timers[i].index = MAX_TIMERS;
 
 	/* reset the quanta */
 	global->quantum_list[0].requested = DEFAULT_MINIMUM_QUANTUM;
@@ -358,15 +371,15 @@ void timer_execute_timers(running_machine *machine)
 		global->exec.curquantum = global->quantum_current->actual;
 	}
 
-	LOG(("timer_set_global_time: new=%s head->expire=%s\n", attotime_string(global->exec.basetime, 9), attotime_string(global->activelist->expire, 9)));
+	LOG(("timer_set_global_time: new=%s head->expire=%s\n", attotime_string(global->exec.basetime, 9), attotime_string(global->active[0]->expire, 9)));
 
 	/* now process any timers that are overdue */
-	while (attotime_compare(global->activelist->expire, global->exec.basetime) <= 0)
+	while (attotime_compare(global->active[0]->expire, global->exec.basetime) <= 0)
 	{
-		int was_enabled = global->activelist->enabled;
+		int was_enabled = global->active[0]->enabled;
 
 		/* if this is a one-shot timer, disable it now */
-		timer = global->activelist;
+		timer = global->active[0];
 		if (attotime_compare(timer->period, attotime_zero) == 0 || attotime_compare(timer->period, attotime_never) == 0)
 			timer->enabled = FALSE;
 
@@ -510,11 +523,10 @@ static void timer_register_save(emu_timer *timer)
 {
 	timer_private *global = timer->machine->timer_data;
 	int count = 0;
-	emu_timer *t;
 
 	/* find other timers that match our func name */
-	for (t = global->activelist; t; t = t->next)
-		if (!strcmp(t->func, timer->func))
+	for (int index = 0; index < global->active_count; index++)
+		if (!strcmp(global->active[index]->func, timer->func))
 			count++;
 
 	/* use different instances to differentiate the bits */
@@ -538,13 +550,13 @@ static void timer_register_save(emu_timer *timer)
 static STATE_POSTLOAD( timer_postload )
 {
 	timer_private *global = machine->timer_data;
-	emu_timer *privlist = NULL;
-	emu_timer *t;
+	emu_timer *privlist[MAX_TIMERS];
+	int count = 0;
 
-	/* remove all timers and make a private list */
-	while (global->activelist != NULL)
+	/* remove all timers in their old order and make a private list */
+	while (global->active_count != 0)
 	{
-		t = global->activelist;
+		emu_timer *t = global->active[0];
 
 		/* temporary timers go away entirely */
 		if (t->temporary)
@@ -554,18 +566,13 @@ static STATE_POSTLOAD( timer_postload )
 		else
 		{
 			timer_list_remove(t);
-			t->next = privlist;
-			privlist = t;
+			privlist[count++] = t;
 		}
 	}
 
-	/* now add them all back in; this effectively re-sorts them by time */
-	while (privlist != NULL)
-	{
-		t = privlist;
-		privlist = t->next;
-		timer_list_insert(t);
-	}
+	/* now add them all back in, last first; this effectively re-sorts them by time */
+	while (count != 0)
+		timer_list_insert(privlist[--count]);
 }
 
 
@@ -577,16 +584,18 @@ static STATE_POSTLOAD( timer_postload )
 int timer_count_anonymous(running_machine *machine)
 {
 	timer_private *global = machine->timer_data;
-	emu_timer *t;
 	int count = 0;
 
 	logerror("timer_count_anonymous:\n");
-	for (t = global->activelist; t; t = t->next)
+	for (int index = 0; index < global->active_count; index++)
+	{
+		emu_timer *t = global->active[index];
 		if (t->temporary && t != global->callback_timer)
 		{
 			count++;
 			logerror("  Temp. timer %p, file %s:%d[%s]\n", (void *) t, t->file, t->line, t->func);
 		}
+	}
 	logerror("%d temporary timers found\n", count);
 
 	return count;
@@ -725,7 +734,7 @@ void timer_adjust_periodic(emu_timer *which, attotime start_delay, INT32 param,
 
 	/* if this was inserted as the head, abort the current timeslice and resync */
 	LOG(("timer_adjust_oneshot %s.%s:%d to expire @ %s\n", which->file, which->func, which->line, attotime_string(which->expire, 9)));
-	if (which == global->activelist)
+	if (which == global->active[0])
 		which->machine->scheduler().abort_timeslice();
 }
 
@@ -937,9 +946,12 @@ static void timer_logtimers(running_machine *machine)
 	logerror("===============\n");
 
 	logerror("Enqueued timers:\n");
-	for (t = global->activelist; t; t = t->next)
+	for (int index = 0; index < global->active_count; index++)
+	{
+		t = global->active[index];
 		logerror("  Start=%15.6f Exp=%15.6f Per=%15.6f Ena=%d Tmp=%d (%s:%d[%s])\n",
 			attotime_to_double(t->start), attotime_to_double(t->expire), attotime_to_double(t->period), t->enabled, t->temporary, t->file, t->line, t->func);
+	}
 
 	logerror("Free timers:\n");
 	for (t = global->freelist; t; t = t->next)
@@ -955,12 +967,57 @@ static void timer_logtimers(running_machine *machine)
 void timer_print_first_timer(running_machine *machine)
 {
 	timer_private *global = machine->timer_data;
-	emu_timer *t = global->activelist;
+	emu_timer *t = global->active[0];
 	printf("  Start=%15.6f Exp=%15.6f Per=%15.6f Ena=%d Tmp=%d (%s)\n",
 		attotime_to_double(t->start), attotime_to_double(t->expire), attotime_to_double(t->period), t->enabled, t->temporary, t->func);
 }
 
 
+/*-------------------------------------------------
+    timer_benchmark - time rescheduling extra
+    timers the way scanline timers are, on top of
+    the machine's own; returns the best of a few
+    runs in osd ticks
+-------------------------------------------------*/
+
+static TIMER_CALLBACK( benchmark_timer_callback )
+{
+}
+
+osd_ticks_t timer_benchmark(running_machine *machine, int timers, int adjustments)
+{
+	timer_private *global = machine->timer_data;
+	emu_timer *timer[MAX_TIMERS];
+	osd_ticks_t best = 0;
+	UINT32 seed = 1;
+
+	/* the timers are temporary, so they are not saved, and never get to fire */
+	timers = MIN(timers, MAX_TIMERS - global->active_count);
+	if (timers <= 0)
+		return 0;
+	for (int index = 0; index < timers; index++)
+		timer[index] = _timer_alloc_common(machine, NULL, 0, benchmark_timer_callback, NULL, __FILE__, __LINE__, "timer_benchmark", TRUE);
+
+	for (int run = 0; run < 5; run++)
+	{
+		osd_ticks_t start = osd_ticks();
+		for (int count = 0; count < adjustments; count++)
+		{
+			/* anywhere up to a frame of 262 lines away */
+			seed = seed * 1103515245 + 12345;
+			timer_adjust_oneshot(timer[count % timers], ATTOTIME_IN_USEC(64 * ((seed >> 16) % 262 + 1)), 0);
+		}
+		osd_ticks_t elapsed = osd_ticks() - start;
+		if (run == 0 || elapsed < best)
+			best = elapsed;
+	}
+
+	for (int index = 0; index < timers; index++)
+		timer_remove(timer[index]);
+	return best;
+}
+
+
 //**************************************************************************
 //  TIMER DEVICE CONFIGURATION
 //**************************************************************************
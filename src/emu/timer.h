@@ -218,6 +218,13 @@ attotime timer_firetime(emu_timer *which);
 
 
 
+/* ----- debugging ----- */
+
+/* time rescheduling extra timers on top of the machine's own */
+osd_ticks_t timer_benchmark(running_machine *machine, int timers, int adjustments);
+
+
+
 // ======================> timer_device_config
 
 class timer_device_config : public device_config
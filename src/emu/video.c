@@ -117,6 +117,7 @@ struct _video_global
 	UINT8					frameskip_counter;		/* counter that counts through the frameskip steps */
 	INT8					frameskip_adjust;
 	UINT8					skipping_this_frame;	/* flag: TRUE if we are skipping the current frame */
+	UINT8					hidden;					/* flag: TRUE if every frame is skipped regardless of frameskip */
 	osd_ticks_t				average_oversleep;		/* average number of ticks the OSD oversleeps */
 
 	/* snapshot stuff */
@@ -675,6 +676,30 @@ void video_set_fastforward(int _fastforward)
 }
 
 
+/*-------------------------------------------------
+    video_get_hidden - return whether frames are
+    currently emulated without rendering
+-------------------------------------------------*/
+
+int video_get_hidden(void)
+{
+	return global.hidden;
+}
+
+
+/*-------------------------------------------------
+    video_set_hidden - emulate frames without
+    rendering them; takes effect on the frame
+    about to run
+-------------------------------------------------*/
+
+void video_set_hidden(int hidden)
+{
+	global.hidden = hidden;
+	global.skipping_this_frame = hidden || skiptable[effective_frameskip()][global.frameskip_counter];
+}
+
+
 /*-------------------------------------------------
     update_throttle - throttle to the game's
     natural speed
@@ -940,7 +965,7 @@ static void update_frameskip(running_machine *machine)
 
 	/* increment the frameskip counter and determine if we will skip the next frame */
 	global.frameskip_counter = (global.frameskip_counter + 1) % FRAMESKIP_LEVELS;
-	global.skipping_this_frame = skiptable[effective_frameskip()][global.frameskip_counter];
+	global.skipping_this_frame = global.hidden || skiptable[effective_frameskip()][global.frameskip_counter];
 }
 
 
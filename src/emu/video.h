@@ -349,6 +349,10 @@ void video_set_throttle(int throttle);
 int video_get_fastforward(void);
 void video_set_fastforward(int fastforward);
 
+/* get/set whether frames are emulated without rendering (e.g. run-ahead) */
+int video_get_hidden(void);
+void video_set_hidden(int hidden);
+
 
 /* ----- snapshots ----- */
 
@@ -140,6 +140,8 @@ static zip_error get_compressed_data_offset(zip_file *zip, UINT64 *offset);
 /* decompression interfaces */
 static zip_error decompress_data_type_0(zip_file *zip, UINT64 offset, void *buffer, UINT32 length);
 static zip_error decompress_data_type_8(zip_file *zip, UINT64 offset, void *buffer, UINT32 length);
+static zip_error stream_data_type_0(zip_file *zip, UINT64 offset, void *buffer, UINT32 length, zip_stream_func callback, void *param);
+static zip_error stream_data_type_8(zip_file *zip, UINT64 offset, void *buffer, UINT32 length, zip_stream_func callback, void *param);
 
 
 
@@ -403,6 +405,46 @@ zip_error zip_file_decompress(zip_file *zip, void *buffer, UINT32 length)
 }
 
 
+/*-------------------------------------------------
+    zip_file_decompress_stream - decompress a
+    file from a ZIP piece by piece, handing each
+    piece to a callback; this needs no more
+    memory than the given buffer
+-------------------------------------------------*/
+
+zip_error zip_file_decompress_stream(zip_file *zip, void *buffer, UINT32 length, zip_stream_func callback, void *param)
+{
+	zip_error ziperr;
+	UINT64 offset;
+
+	/* make sure the info in the header aligns with what we know */
+	if (zip->header.start_disk_number != zip->ecd.disk_number)
+		return ZIPERR_UNSUPPORTED;
+
+	/* get the compressed data offset */
+	ziperr = get_compressed_data_offset(zip, &offset);
+	if (ziperr != ZIPERR_NONE)
+		return ziperr;
+
+	/* handle compression types */
+	switch (zip->header.compression)
+	{
+		case 0:
+			ziperr = stream_data_type_0(zip, offset, buffer, length, callback, param);
+			break;
+
+		case 8:
+			ziperr = stream_data_type_8(zip, offset, buffer, length, callback, param);
+			break;
+
+		default:
+			ziperr = ZIPERR_UNSUPPORTED;
+			break;
+	}
+	return ziperr;
+}
+
+
 
 /***************************************************************************
     CACHE MANAGEMENT
@@ -643,3 +685,134 @@ static zip_error decompress_data_type_8(zip_file *zip, UINT64 offset, void *buff
 
 	return ZIPERR_NONE;
 }
+
+
+/*-------------------------------------------------
+    stream_data_type_0 - pass on type 0 data
+    (which is uncompressed) piece by piece
+-------------------------------------------------*/
+
+static zip_error stream_data_type_0(zip_file *zip, UINT64 offset, void *buffer, UINT32 length, zip_stream_func callback, void *param)
+{
+	UINT32 input_remaining = zip->header.compressed_length;
+	file_error filerr;
+	UINT32 read_length;
+
+	while (input_remaining > 0)
+	{
+		filerr = osd_read(zip->file, buffer, offset, MIN(input_remaining, length), &read_length);
+		if (filerr != FILERR_NONE)
+			return ZIPERR_FILE_ERROR;
+		if (read_length == 0)
+			return ZIPERR_FILE_TRUNCATED;
+
+		(*callback)(param, buffer, read_length);
+		offset += read_length;
+		input_remaining -= read_length;
+	}
+	return ZIPERR_NONE;
+}
+
+
+/*-------------------------------------------------
+    stream_data_type_8 - decompress type 8 data
+    (which is deflated) piece by piece
+-------------------------------------------------*/
+
+static zip_error stream_data_type_8(zip_file *zip, UINT64 offset, void *buffer, UINT32 length, zip_stream_func callback, void *param)
+{
+	UINT32 input_remaining = zip->header.compressed_length;
+	UINT32 output_total = 0;
+	UINT32 read_length;
+	z_stream stream;
+	int filerr;
+	int zerr;
+
+	/* make sure we don't need a newer mechanism */
+	if (zip->header.version_needed > 0x14)
+		return ZIPERR_UNSUPPORTED;
+
+	/* reset the stream */
+	memset(&stream, 0, sizeof(stream));
+	stream.next_out = (Bytef *)buffer;
+	stream.avail_out = length;
+
+	/* initialize the decompressor */
+	zerr = inflateInit2(&stream, -MAX_WBITS);
+	if (zerr != Z_OK)
+		return ZIPERR_DECOMPRESS_ERROR;
+
+	/* loop until we're done */
+	while (1)
+	{
+		/* read in the next chunk of data once the last one is used up */
+		if (stream.avail_in == 0 && input_remaining > 0)
+		{
+			filerr = osd_read(zip->file, zip->buffer, offset, MIN(input_remaining, sizeof(zip->buffer)), &read_length);
+			if (filerr != FILERR_NONE)
+			{
+				inflateEnd(&stream);
+				return ZIPERR_FILE_ERROR;
+			}
+			if (read_length == 0)
+			{
+				inflateEnd(&stream);
+				return ZIPERR_FILE_TRUNCATED;
+			}
+			offset += read_length;
+
+			/* fill out the input data */
+			stream.next_in = zip->buffer;
+			stream.avail_in = read_length;
+			input_remaining -= read_length;
+
+			/* add a dummy byte at end of compressed data */
+			if (input_remaining == 0)
+				stream.avail_in++;
+		}
+
+		/* now inflate */
+		zerr = inflate(&stream, Z_NO_FLUSH);
+		if (zerr != Z_OK && zerr != Z_STREAM_END)
+		{
+			inflateEnd(&stream);
+			return ZIPERR_DECOMPRESS_ERROR;
+		}
+
+		/* hand over the output whenever the buffer fills up or the data ends */
+		if (stream.avail_out == 0 || zerr == Z_STREAM_END)
+		{
+			UINT32 produced = length - stream.avail_out;
+
+			if (produced > 0)
+				(*callback)(param, buffer, produced);
+			output_total += produced;
+			stream.next_out = (Bytef *)buffer;
+			stream.avail_out = length;
+
+			/* a full buffer may have left output behind in the decompressor */
+			if (zerr == Z_OK)
+				continue;
+		}
+		if (zerr == Z_STREAM_END)
+			break;
+
+		/* out of input without reaching the end of the stream */
+		if (stream.avail_in == 0 && input_remaining == 0)
+		{
+			inflateEnd(&stream);
+			return ZIPERR_DECOMPRESS_ERROR;
+		}
+	}
+
+	/* finish decompression */
+	zerr = inflateEnd(&stream);
+	if (zerr != Z_OK)
+		return ZIPERR_DECOMPRESS_ERROR;
+
+	/* if anything looks funny, report an error */
+	if (output_total != zip->header.uncompressed_length || input_remaining > 0)
+		return ZIPERR_DECOMPRESS_ERROR;
+
+	return ZIPERR_NONE;
+}
@@ -120,6 +120,10 @@ struct _zip_ecd
 };
 
 
+/* receives consecutive pieces of a file being decompressed */
+typedef void (*zip_stream_func)(void *param, const void *data, UINT32 length);
+
+
 /* describes an open ZIP file */
 typedef struct _zip_file zip_file;
 struct _zip_file
@@ -167,5 +171,9 @@ const zip_file_header *zip_file_next_file(zip_file *zip);
 /* decompress the most recently found file in the ZIP */
 zip_error zip_file_decompress(zip_file *zip, void *buffer, UINT32 length);
 
+/* decompress the most recently found file in the ZIP, passing it to the callback
+   in pieces of up to length bytes decompressed into buffer */
+zip_error zip_file_decompress_stream(zip_file *zip, void *buffer, UINT32 length, zip_stream_func callback, void *param);
+
 
 #endif	/* __UNZIP_H__ */
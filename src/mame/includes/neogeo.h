@@ -42,11 +42,26 @@ public:
 	/* video-related */
 	pen_t		*pens;
 	UINT16		*videoram;
+	UINT8		*videoram_dirty;	/* set on every write, for rewind snapshots */
 	UINT16		*palettes[2];		/* 0x100*16 2 byte palette entries */
-	UINT8		*sprite_gfx;
+	UINT8		*sprite_gfx;		/* "sprites" region, converted in place to packed 4bpp lines */
 	const UINT8	*region_zoomy;
 
+	/* sprite index: effective Y/height of every sprite and the sprites touching each 16 line band */
+	INT16		*sprite_index_y;
+	UINT8		*sprite_index_rows;
+	UINT32		*sprite_index_bands;
+	UINT32		*sprite_index_band_list;
+	UINT16		sprite_index_dirty_min;
+	UINT16		sprite_index_dirty_max;
+
+	/* raster synchronization: sprite lists are parsed and lines drawn up to the beam only when needed */
+	UINT16		*sprite_line_lists;	/* active sprite list of every line, as parsed at its start */
+	attotime	video_sync_time;	/* start of the line after the last synchronization */
+	UINT16		sprite_line_next;	/* next line whose sprite list is to be parsed */
+
 	UINT32		sprite_gfx_address_mask;
+	UINT32		sprite_gfx_length;
 	UINT16		videoram_read_buffer;
 	UINT16		videoram_write_buffer2;
 	UINT16		videoram_modulo;
@@ -146,6 +146,32 @@ struct optimised_sbox
 	UINT8 output[64];
 };
 
+// the 2nd FN always swaps the same bits in and out, so it does so with byte lookups
+struct fn2_swap_tables
+{
+	UINT16 split[2][256];	// low/high byte of the input -> (l << 8) | r
+	UINT16 merge[2][256];	// l/r -> output bits
+};
+
+struct cps2_decrypt_state
+{
+	const UINT16 *rom;
+	UINT16 *dec;
+	int words;						// number of encrypted words
+	const UINT32 *master_key;
+	UINT32 key1[4];
+	struct optimised_sbox sboxes1[4 * 4];
+	struct optimised_sbox sboxes2[4 * 4];
+	struct fn2_swap_tables swap;
+	INT32 volatile done;			// seeds finished so far, for the progress text
+};
+
+struct cps2_decrypt_chunk
+{
+	struct cps2_decrypt_state *state;
+	int start, end;					// range of seeds
+};
+
 
 static const struct sbox fn1_r1_boxes[4] =
 {
@@ -584,6 +610,49 @@ static UINT16 feistel(UINT16 val, const int *bitsA, const int *bitsB,
 
 
 
+// same as feistel() with fn2_groupA/fn2_groupB as the bit groups
+static UINT16 feistel_fn2(UINT16 val, const struct fn2_swap_tables *swap, const struct optimised_sbox *boxes, const UINT32 *key)
+{
+	UINT16 lr = swap->split[0][val & 0xff] | swap->split[1][val >> 8];
+	UINT8 l = lr >> 8;
+	UINT8 r = lr & 0xff;
+
+	l ^= fn(r, &boxes[0 * 4], key[0]);
+	r ^= fn(l, &boxes[1 * 4], key[1]);
+	l ^= fn(r, &boxes[2 * 4], key[2]);
+	r ^= fn(l, &boxes[3 * 4], key[3]);
+
+	return swap->merge[0][l] | swap->merge[1][r];
+}
+
+
+
+static void optimise_swaps(struct fn2_swap_tables *out, const int *bitsA, const int *bitsB)
+{
+	int i, bit;
+
+	memset(out, 0, sizeof(*out));
+
+	for (i = 0; i < 256; ++i)
+		for (bit = 0; bit < 8; ++bit)
+		{
+			// input bit bitsB[n] goes to bit n of l, bitsA[n] to bit n of r
+			if (BIT(i, bitsB[bit] & 7))
+				out->split[bitsB[bit] >> 3][i] |= 0x100 << bit;
+			if (BIT(i, bitsA[bit] & 7))
+				out->split[bitsA[bit] >> 3][i] |= 1 << bit;
+
+			// bit n of l goes back to bitsA[n], bit n of r to bitsB[n]
+			if (BIT(i, bit))
+			{
+				out->merge[0][i] |= 1 << bitsA[bit];
+				out->merge[1][i] |= 1 << bitsB[bit];
+			}
+		}
+}
+
+
+
 static int extract_inputs(UINT32 val, const int *inputs)
 {
 	int i;
@@ -630,69 +699,30 @@ static void optimise_sboxes(struct optimised_sbox* out, const struct sbox* in)
 
 
 
-static void cps2_decrypt(running_machine *machine, const UINT32 *master_key, UINT32 upper_limit)
+// each seed decrypts the words at seed, seed + 0x10000, seed + 0x20000, ...
+static void decrypt_seeds(struct cps2_decrypt_state *state, int start, int end)
 {
-	address_space *space = cputag_get_address_space(machine, "maincpu", ADDRESS_SPACE_PROGRAM);
-	UINT16 *rom = (UINT16 *)memory_region(machine, "maincpu");
-	int length = memory_region_length(machine, "maincpu");
-	UINT16 *dec = auto_alloc_array(machine, UINT16, length / 2);
 	int i;
-	UINT32 key1[4];
-	struct optimised_sbox sboxes1[4 * 4];
-	struct optimised_sbox sboxes2[4 * 4];
-
-	optimise_sboxes(&sboxes1[0 * 4], fn1_r1_boxes);
-	optimise_sboxes(&sboxes1[1 * 4], fn1_r2_boxes);
-	optimise_sboxes(&sboxes1[2 * 4], fn1_r3_boxes);
-	optimise_sboxes(&sboxes1[3 * 4], fn1_r4_boxes);
-	optimise_sboxes(&sboxes2[0 * 4], fn2_r1_boxes);
-	optimise_sboxes(&sboxes2[1 * 4], fn2_r2_boxes);
-	optimise_sboxes(&sboxes2[2 * 4], fn2_r3_boxes);
-	optimise_sboxes(&sboxes2[3 * 4], fn2_r4_boxes);
-
 
-	// expand master key to 1st FN 96-bit key
-	expand_1st_key(key1, master_key);
-
-	// add extra bits for s-boxes with less than 6 inputs
-	key1[0] ^= BIT(key1[0], 1) <<  4;
-	key1[0] ^= BIT(key1[0], 2) <<  5;
-	key1[0] ^= BIT(key1[0], 8) << 11;
-	key1[1] ^= BIT(key1[1], 0) <<  5;
-	key1[1] ^= BIT(key1[1], 8) << 11;
-	key1[2] ^= BIT(key1[2], 1) <<  5;
-	key1[2] ^= BIT(key1[2], 8) << 11;
-
-	int tmp1 = length / 2;
-	UINT32 tmp2 = upper_limit / 2;
-
-	for (i = 0; i < 0x10000; ++i)
+	for (i = start; i < end; ++i)
 	{
 		int a;
 		UINT16 seed;
 		UINT32 subkey[2];
 		UINT32 key2[4];
 
-		if ((i & 0xff) == 0)
-		{
-			char loadingMessage[256]; // for displaying with UI
-			sprintf(loadingMessage, "Decrypting %d%%", i * 100 / 0x10000);
-			ui_set_startup_text(machine, loadingMessage, FALSE);
-		}
-
-
 		// pass the address through FN1
 		seed = feistel(i, fn1_groupA, fn1_groupB,
-				&sboxes1[0 * 4], &sboxes1[1 * 4], &sboxes1[2 * 4], &sboxes1[3 * 4],
-				key1[0], key1[1], key1[2], key1[3]);
+				&state->sboxes1[0 * 4], &state->sboxes1[1 * 4], &state->sboxes1[2 * 4], &state->sboxes1[3 * 4],
+				state->key1[0], state->key1[1], state->key1[2], state->key1[3]);
 
 
 		// expand the result to 64-bit
 		expand_subkey(subkey, seed);
 
 		// XOR with the master key
-		subkey[0] ^= master_key[0];
-		subkey[1] ^= master_key[1];
+		subkey[0] ^= state->master_key[0];
+		subkey[1] ^= state->master_key[1];
 
 		// expand key to 2nd FN 96-bit key
 		expand_2nd_key(key2, subkey);
@@ -709,20 +739,122 @@ static void cps2_decrypt(running_machine *machine, const UINT32 *master_key, UIN
 
 
 		// decrypt the opcodes
-		for (a = i; a < tmp1 && a < tmp2; a += 0x10000)
-		{
-			dec[a] = feistel(rom[a], fn2_groupA, fn2_groupB,
-				&sboxes2[0 * 4], &sboxes2[1 * 4], &sboxes2[2 * 4], &sboxes2[3 * 4],
-				key2[0], key2[1], key2[2], key2[3]);
-		}
-		// copy the unencrypted part (not really needed)
-		while (a < tmp1)
+		for (a = i; a < state->words; a += 0x10000)
+			state->dec[a] = feistel_fn2(state->rom[a], &state->swap, state->sboxes2, key2);
+	}
+
+	atomic_add32(&state->done, end - start);
+}
+
+
+
+static void *decrypt_chunk_callback(void *param, int threadid)
+{
+	const struct cps2_decrypt_chunk *chunk = (const struct cps2_decrypt_chunk *)param;
+
+	decrypt_seeds(chunk->state, chunk->start, chunk->end);
+	return NULL;
+}
+
+
+
+static void show_decrypt_progress(running_machine *machine, const struct cps2_decrypt_state *state)
+{
+	char loadingMessage[256]; // for displaying with UI
+	sprintf(loadingMessage, "Decrypting %d%%", state->done * 100 / 0x10000);
+	ui_set_startup_text(machine, loadingMessage, FALSE);
+}
+
+
+
+// the seeds are split into this many independent chunks
+#define DECRYPT_CHUNKS	64
+
+static void cps2_decrypt(running_machine *machine, const UINT32 *master_key, UINT32 upper_limit)
+{
+	address_space *space = cputag_get_address_space(machine, "maincpu", ADDRESS_SPACE_PROGRAM);
+	UINT16 *rom = (UINT16 *)memory_region(machine, "maincpu");
+	int length = memory_region_length(machine, "maincpu");
+	UINT16 *dec;
+	int i;
+	struct cps2_decrypt_state *state;
+	struct cps2_decrypt_chunk chunk[DECRYPT_CHUNKS];
+	osd_work_queue *queue;
+
+	/* the decrypted opcodes are never written, so a cached copy can be used in place */
+	dec = (UINT16 *)region_cache_find(machine, "maincpu.opcodes", length);
+	if (dec != NULL)
+	{
+		space->set_decrypted_region(0x000000, length - 1, dec);
+		m68k_set_encrypted_opcode_range(machine->device("maincpu"), 0, length);
+		return;
+	}
+
+	dec = auto_alloc_array(machine, UINT16, length / 2);
+	state = auto_alloc_clear(machine, struct cps2_decrypt_state);
+
+	state->rom = rom;
+	state->dec = dec;
+	state->words = MIN(length / 2, upper_limit / 2);
+	state->master_key = master_key;
+
+	optimise_sboxes(&state->sboxes1[0 * 4], fn1_r1_boxes);
+	optimise_sboxes(&state->sboxes1[1 * 4], fn1_r2_boxes);
+	optimise_sboxes(&state->sboxes1[2 * 4], fn1_r3_boxes);
+	optimise_sboxes(&state->sboxes1[3 * 4], fn1_r4_boxes);
+	optimise_sboxes(&state->sboxes2[0 * 4], fn2_r1_boxes);
+	optimise_sboxes(&state->sboxes2[1 * 4], fn2_r2_boxes);
+	optimise_sboxes(&state->sboxes2[2 * 4], fn2_r3_boxes);
+	optimise_sboxes(&state->sboxes2[3 * 4], fn2_r4_boxes);
+	optimise_swaps(&state->swap, fn2_groupA, fn2_groupB);
+
+
+	// expand master key to 1st FN 96-bit key
+	expand_1st_key(state->key1, master_key);
+
+	// add extra bits for s-boxes with less than 6 inputs
+	state->key1[0] ^= BIT(state->key1[0], 1) <<  4;
+	state->key1[0] ^= BIT(state->key1[0], 2) <<  5;
+	state->key1[0] ^= BIT(state->key1[0], 8) << 11;
+	state->key1[1] ^= BIT(state->key1[1], 0) <<  5;
+	state->key1[1] ^= BIT(state->key1[1], 8) << 11;
+	state->key1[2] ^= BIT(state->key1[2], 1) <<  5;
+	state->key1[2] ^= BIT(state->key1[2], 8) << 11;
+
+	// copy the unencrypted part (not really needed)
+	if (state->words < length / 2)
+		memcpy(&dec[state->words], &rom[state->words], length - state->words * 2);
+
+	// every seed is independent, so spread them over all processors
+	for (i = 0; i < DECRYPT_CHUNKS; ++i)
+	{
+		chunk[i].state = state;
+		chunk[i].start = i * (0x10000 / DECRYPT_CHUNKS);
+		chunk[i].end = (i + 1) * (0x10000 / DECRYPT_CHUNKS);
+	}
+
+	queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+
+	if (queue != NULL)
+	{
+		osd_work_item_queue_multiple(queue, decrypt_chunk_callback, DECRYPT_CHUNKS, chunk, sizeof(chunk[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+		while (!osd_work_queue_wait(queue, osd_ticks_per_second() / 10))
+			show_decrypt_progress(machine, state);
+		osd_work_queue_free(queue);
+	}
+	else
+	{
+		for (i = 0; i < DECRYPT_CHUNKS; ++i)
 		{
-			dec[a] = rom[a];
-			a += 0x10000;
+			show_decrypt_progress(machine, state);
+			decrypt_seeds(state, chunk[i].start, chunk[i].end);
 		}
 	}
 
+	auto_free(machine, state);
+
+	region_cache_add(machine, "maincpu.opcodes", dec, length);
+
 	space->set_decrypted_region(0x000000, length - 1, dec);
 	m68k_set_encrypted_opcode_range(machine->device("maincpu"), 0, length);
 }
@@ -528,34 +528,52 @@ static void decrypt(UINT8 *r0, UINT8 *r1,
 }
 
 
-static void neogeo_gfx_decrypt(running_machine *machine, int extra_xor)
+/* each pass is split into this many independent pieces of the ROM */
+#define GFX_DECRYPT_CHUNKS	64
+
+struct gfx_decrypt_chunk
 {
-	int rom_size;
-	UINT8 *buf;
 	UINT8 *rom;
-	int rpos;
-
-	rom_size = memory_region_length(machine, "sprites");
+	UINT8 *buf;
+	int rom_size;
+	int extra_xor;
+	int start, end;		/* range of 32-bit words */
+};
 
-	buf = auto_alloc_array(machine, UINT8, rom_size);
 
-	rom = memory_region(machine, "sprites");
+static void *gfx_decrypt_data(void *param, int threadid)
+{
+	const struct gfx_decrypt_chunk *chunk = (const struct gfx_decrypt_chunk *)param;
+	const UINT8 *rom = chunk->rom;
+	UINT8 *buf = chunk->buf;
+	int rpos;
 
 	// Data xor
-	for (rpos = 0;rpos < rom_size/4;rpos++)
+	for (rpos = chunk->start;rpos < chunk->end;rpos++)
 	{
 		decrypt(buf+4*rpos+0, buf+4*rpos+3, rom[4*rpos+0], rom[4*rpos+3], type0_t03, type0_t12, type1_t03, rpos, (rpos>>8) & 1);
 		decrypt(buf+4*rpos+1, buf+4*rpos+2, rom[4*rpos+1], rom[4*rpos+2], type0_t12, type0_t03, type1_t12, rpos, ((rpos>>16) ^ address_16_23_xor2[(rpos>>8) & 0xff]) & 1);
 	}
+	return NULL;
+}
+
+
+static void *gfx_decrypt_address(void *param, int threadid)
+{
+	const struct gfx_decrypt_chunk *chunk = (const struct gfx_decrypt_chunk *)param;
+	UINT32 *rom = (UINT32 *)chunk->rom;
+	const UINT32 *buf = (const UINT32 *)chunk->buf;
+	int rom_size = chunk->rom_size;
+	int rpos;
 
 	// Address xor
-	for (rpos = 0;rpos < rom_size/4;rpos++)
+	for (rpos = chunk->start;rpos < chunk->end;rpos++)
 	{
 		int baser;
 
 		baser = rpos;
 
-		baser ^= extra_xor;
+		baser ^= chunk->extra_xor;
 
 		baser ^= address_8_15_xor1[(baser >> 16) & 0xff] << 8;
 		baser ^= address_8_15_xor2[baser & 0xff] << 8;
@@ -581,13 +599,77 @@ static void neogeo_gfx_decrypt(running_machine *machine, int extra_xor)
 		else /* Clamp to the real rom size */
 			baser &= (rom_size/4)-1;
 
-		rom[4*rpos+0] = buf[4*baser+0];
-		rom[4*rpos+1] = buf[4*baser+1];
-		rom[4*rpos+2] = buf[4*baser+2];
-		rom[4*rpos+3] = buf[4*baser+3];
+		/* the scrambling moves whole 32-bit words */
+		rom[rpos] = buf[baser];
+	}
+	return NULL;
+}
+
+
+static void gfx_decrypt_pass(osd_work_queue *queue, osd_work_callback callback, struct gfx_decrypt_chunk *chunk)
+{
+	int i;
+
+	if (queue == NULL)
+	{
+		for (i = 0; i < GFX_DECRYPT_CHUNKS; i++)
+			(*callback)(&chunk[i], 0);
+		return;
 	}
 
+	osd_work_item_queue_multiple(queue, callback, GFX_DECRYPT_CHUNKS, chunk, sizeof(chunk[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+	while (!osd_work_queue_wait(queue, osd_ticks_per_second()))
+		;
+}
+
+
+static void neogeo_gfx_decrypt(running_machine *machine, int extra_xor, int sfix)
+{
+	struct gfx_decrypt_chunk chunk[GFX_DECRYPT_CHUNKS];
+	osd_work_queue *queue;
+	int rom_size;
+	UINT8 *buf;
+	UINT8 *rom;
+	int i;
+
+	rom_size = memory_region_length(machine, "sprites");
+
+	/* the sprites are only cached once the video start has packed them, which
+       replaces the whole region; all that is needed from the decrypted data
+       before that is the fixed layer some games take from it */
+	if (region_cache_find(machine, "sprites.packed", rom_size) != NULL && (!sfix || region_cache_load_region(machine, "fixed", "cmc")))
+		return;
+
+	buf = auto_alloc_array(machine, UINT8, rom_size);
+
+	rom = memory_region(machine, "sprites");
+
+	/* every word is decrypted independently, so spread the passes over all processors */
+	for (i = 0; i < GFX_DECRYPT_CHUNKS; i++)
+	{
+		chunk[i].rom = rom;
+		chunk[i].buf = buf;
+		chunk[i].rom_size = rom_size;
+		chunk[i].extra_xor = extra_xor;
+		chunk[i].start = (INT64)(rom_size/4) * i / GFX_DECRYPT_CHUNKS;
+		chunk[i].end = (INT64)(rom_size/4) * (i + 1) / GFX_DECRYPT_CHUNKS;
+	}
+
+	queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+
+	gfx_decrypt_pass(queue, gfx_decrypt_data, chunk);
+	gfx_decrypt_pass(queue, gfx_decrypt_address, chunk);
+
+	if (queue != NULL)
+		osd_work_queue_free(queue);
+
 	auto_free(machine, buf);
+
+	if (sfix)
+	{
+		neogeo_sfix_decrypt(machine);
+		region_cache_save_region(machine, "fixed", "cmc");
+	}
 }
 
 
@@ -617,8 +699,7 @@ void kof99_neogeo_gfx_decrypt(running_machine *machine, int extra_xor)
 	address_16_23_xor1 = kof99_address_16_23_xor1;
 	address_16_23_xor2 = kof99_address_16_23_xor2;
 	address_0_7_xor =    kof99_address_0_7_xor;
-	neogeo_gfx_decrypt(machine, extra_xor);
-	neogeo_sfix_decrypt(machine);
+	neogeo_gfx_decrypt(machine, extra_xor, TRUE);
 }
 
 
@@ -634,8 +715,7 @@ void kof2000_neogeo_gfx_decrypt(running_machine *machine, int extra_xor)
 	address_16_23_xor1 = kof2000_address_16_23_xor1;
 	address_16_23_xor2 = kof2000_address_16_23_xor2;
 	address_0_7_xor =    kof2000_address_0_7_xor;
-	neogeo_gfx_decrypt(machine, extra_xor);
-	neogeo_sfix_decrypt(machine);
+	neogeo_gfx_decrypt(machine, extra_xor, TRUE);
 }
 
 
@@ -651,7 +731,7 @@ void cmc42_neogeo_gfx_decrypt(running_machine *machine, int extra_xor)
 	address_16_23_xor1 = kof99_address_16_23_xor1;
 	address_16_23_xor2 = kof99_address_16_23_xor2;
 	address_0_7_xor =    kof99_address_0_7_xor;
-	neogeo_gfx_decrypt(machine, extra_xor);
+	neogeo_gfx_decrypt(machine, extra_xor, FALSE);
 }
 
 
@@ -667,7 +747,7 @@ void cmc50_neogeo_gfx_decrypt(running_machine *machine, int extra_xor)
 	address_16_23_xor1 = kof2000_address_16_23_xor1;
 	address_16_23_xor2 = kof2000_address_16_23_xor2;
 	address_0_7_xor =    kof2000_address_0_7_xor;
-	neogeo_gfx_decrypt(machine, extra_xor);
+	neogeo_gfx_decrypt(machine, extra_xor, FALSE);
 }
 
 
@@ -10,6 +10,9 @@
 
 #define NUM_PENS	(0x1000)
 
+static void mark_sprite_index_dirty(running_machine *machine, int first, int last);
+static void video_sync(running_machine *machine);
+
 /*************************************
  *
  *  Video RAM access
@@ -21,6 +24,9 @@ static void set_videoram_offset(running_machine *machine, UINT16 data)
 	neogeo_state *state = machine->driver_data<neogeo_state>();
 
 	state->videoram_offset = (data & 0x8000 ? data & 0x87ff : data);
+	/* the sprite lists are only written when the beam is caught up with */
+	if ((state->videoram_offset & 0xff00) == 0x8600)
+		video_sync(machine);
 	/* the read happens right away */
 	state->videoram_read_buffer = state->videoram[state->videoram_offset];
 }
@@ -35,7 +41,12 @@ static void set_videoram_data(running_machine *machine, UINT16 data)
 {
 	neogeo_state *state = machine->driver_data<neogeo_state>();
 
+	video_sync(machine);
 	state->videoram[state->videoram_offset] = data;
+	*state->videoram_dirty = TRUE;
+	/* Y position, height or chain bit of a sprite changed */
+	if ((state->videoram_offset & 0xfe00) == 0x8200)
+		mark_sprite_index_dirty(machine, state->videoram_offset & 0x01ff, state->videoram_offset & 0x01ff);
 	/* auto increment/decrement the current offset - A15 is NOT effected */
 	set_videoram_offset(machine, ((state->videoram_offset & 0x8000) | ((state->videoram_offset + state->videoram_modulo) & 0x7fff)));
 }
@@ -143,6 +154,7 @@ void neogeo_set_palette_bank( running_machine *machine, UINT8 data )
 
 	if (data != state->palette_bank)
 	{
+		video_sync(machine);
 		state->palette_bank = data;
 		regenerate_pens(machine, NULL);
 	}
@@ -154,6 +166,7 @@ void neogeo_set_screen_dark( running_machine *machine, UINT8 data )
 
 	if (data != state->screen_dark)
 	{
+		video_sync(machine);
 		state->screen_dark = data;
 		regenerate_pens(machine, NULL);
 	}
@@ -171,6 +184,7 @@ WRITE16_HANDLER( neogeo_paletteram_w )
 	neogeo_state *state = space->machine->driver_data<neogeo_state>();
 
 	UINT16 *addr = &state->palettes[state->palette_bank][offset];
+	video_sync(space->machine);
 	COMBINE_DATA(addr);
 
 	state->pens[offset] = get_pen(space->machine, *addr);
@@ -192,7 +206,12 @@ static void set_auto_animation_speed( running_machine *machine, UINT8 data)
 static void set_auto_animation_disabled( running_machine *machine, UINT8 data)
 {
 	neogeo_state *state = machine->driver_data<neogeo_state>();
-	state->auto_animation_disabled = data;
+
+	if (data != state->auto_animation_disabled)
+	{
+		video_sync(machine);
+		state->auto_animation_disabled = data;
+	}
 }
 
 UINT8 neogeo_get_auto_animation_counter( running_machine *machine )
@@ -207,6 +226,7 @@ static TIMER_CALLBACK( auto_animation_timer_callback )
 
 	if (state->auto_animation_frame_counter == 0)
 	{
+		video_sync(machine);
 		state->auto_animation_frame_counter = state->auto_animation_speed;
 		state->auto_animation_counter += 1;
 	}
@@ -238,7 +258,12 @@ static void start_auto_animation_timer( running_machine *machine )
 void neogeo_set_fixed_layer_source( running_machine *machine, UINT8 data )
 {
 	neogeo_state *state = machine->driver_data<neogeo_state>();
-	state->fixed_layer_source = data;
+
+	if (data != state->fixed_layer_source)
+	{
+		video_sync(machine);
+		state->fixed_layer_source = data;
+	}
 }
 
 
@@ -323,6 +348,9 @@ static void draw_fixed_layer( running_machine *machine, bitmap_t *bitmap, int sc
 #define MAX_SPRITES_PER_SCREEN    (381)
 #define MAX_SPRITES_PER_LINE      (96)
 
+#define SPRITE_INDEX_BANDS        (0x200 >> 4)
+#define SPRITE_INDEX_WORDS        ((MAX_SPRITES_PER_SCREEN + 31) >> 5)
+
 
 /* horizontal zoom table - verified on real hardware */
 static const int zoom_x_tables[16][16] =
@@ -365,8 +393,8 @@ static void draw_sprites( running_machine *machine, bitmap_t *bitmap, int scanli
 {
 	neogeo_state *state = machine->driver_data<neogeo_state>();
 
-	/* select the active list */
-	UINT16 *sprite_list = (scanline & 0x01) ? &state->videoram[0x8680] : &state->videoram[0x8600];
+	/* the active list as it was parsed at the start of the line */
+	UINT16 *sprite_list = &state->sprite_line_lists[scanline * (MAX_SPRITES_PER_LINE + 1)];
 	INT32 y = 0, zoom_y = 0, x = 0, zoom_x = 0, rows = 0;
 
 	/* optimization -- find last non-zero entry and only draw that many +1
@@ -458,9 +486,27 @@ static void draw_sprites( running_machine *machine, bitmap_t *bitmap, int scanli
 
 			const int *zoom_x_table = zoom_x_tables[zoom_x];
 			/* compute offset in gfx ROM and mask it to the number of bits available */
-			UINT8 *gfx = &state->sprite_gfx[((code << 8) | (sprite_y << 4)) & state->sprite_gfx_address_mask];
+			offs_t gfx_offs = ((code << 7) | (sprite_y << 3)) & state->sprite_gfx_address_mask;
 			pen_t *line_pens = &state->pens[attr >> 8 << 4];
 
+			/* past the end of the ROM, or a fully transparent line: nothing to draw */
+			if (gfx_offs >= state->sprite_gfx_length)
+				continue;
+
+			const UINT8 *packed = &state->sprite_gfx[gfx_offs];
+			if ((packed[0] | packed[1] | packed[2] | packed[3] | packed[4] | packed[5] | packed[6] | packed[7]) == 0)
+				continue;
+
+			/* unpack the 16 pixels of the line, two per byte */
+			UINT8 line_pixels[0x10];
+			for (UINT32 i = 0; i < 8; i++)
+			{
+				line_pixels[i << 1] = packed[i] & 0x0f;
+				line_pixels[(i << 1) | 1] = packed[i] >> 4;
+			}
+
+			const UINT8 *gfx = line_pixels;
+
 			INT32 x_inc;
 			/* horizontal flip? */
 			if (attr & 0x0001)
@@ -516,17 +562,70 @@ static void draw_sprites( running_machine *machine, bitmap_t *bitmap, int scanli
 }
 
 
-static void parse_sprites( running_machine *machine, int scanline )
+/*************************************
+ *
+ *  Sprite index
+ *
+ *  parse_sprites runs on every scanline, so instead of walking all
+ *  sprite control words each time we keep, for every 16 line band,
+ *  a bitmap of the sprites whose Y range touches it.  Sprites only
+ *  move when their y_control word (0x8200) is written, so the index
+ *  is brought up to date lazily from the lowest dirty sprite, and
+ *  the walk stops as soon as the chain no longer changes anything.
+ *
+ *************************************/
+
+static void mark_sprite_index_dirty( running_machine *machine, int first, int last )
 {
 	neogeo_state *state = machine->driver_data<neogeo_state>();
 
-	/* select the active list */
-	UINT16 *sprite_list = (scanline & 0x01) ? &state->videoram[0x8680] : &state->videoram[0x8600];
-	UINT32 active_sprite_count = 0;
-	INT32 y = 0, rows = 0;
+	if (first >= MAX_SPRITES_PER_SCREEN)
+		return;
+
+	if (last >= MAX_SPRITES_PER_SCREEN)
+		last = MAX_SPRITES_PER_SCREEN - 1;
+
+	if (first < state->sprite_index_dirty_min)
+		state->sprite_index_dirty_min = first;
+
+	if (last > state->sprite_index_dirty_max)
+		state->sprite_index_dirty_max = last;
+}
+
+
+INLINE UINT32 sprite_bands(int y, int rows)
+{
+	/* sprites with 0 rows are never drawn; 0x20 rows or more cover every line */
+	if (rows == 0)
+		return 0;
+
+	if (rows >= 0x20)
+		return 0xffffffff;
 
-	/* scan all sprites */
-	for (UINT16 sprite_number = 0; sprite_number < MAX_SPRITES_PER_SCREEN; sprite_number++)
+	UINT32 bands = 0;
+	INT32 first_line = y & 0x01ff;
+	INT32 count = ((first_line & 0x0f) + (rows << 4) + 0x0f) >> 4;
+
+	for (INT32 band = first_line >> 4; count > 0; count--, band = (band + 1) & (SPRITE_INDEX_BANDS - 1))
+		bands |= 1 << band;
+
+	return bands;
+}
+
+
+static void update_sprite_index( running_machine *machine )
+{
+	neogeo_state *state = machine->driver_data<neogeo_state>();
+
+	if (state->sprite_index_dirty_min >= MAX_SPRITES_PER_SCREEN)
+		return;
+
+	/* chained sprites inherit the position of the previous one */
+	INT32 sprite_number = state->sprite_index_dirty_min;
+	INT32 y = (sprite_number > 0) ? state->sprite_index_y[sprite_number - 1] : 0;
+	INT32 rows = (sprite_number > 0) ? state->sprite_index_rows[sprite_number - 1] : 0;
+
+	for ( ; sprite_number < MAX_SPRITES_PER_SCREEN; sprite_number++)
 	{
 		UINT16 y_control = state->videoram[0x8200 | sprite_number];
 
@@ -537,45 +636,166 @@ static void parse_sprites( running_machine *machine, int scanline )
 			rows = y_control & 0x3f;
 		}
 
-		/* skip sprites with 0 rows */
-		if (rows == 0)
-			continue;
+		/* past the written range, an unchanged sprite means the rest of the chain is unchanged too */
+		if (sprite_number > state->sprite_index_dirty_max &&
+			y == state->sprite_index_y[sprite_number] && rows == state->sprite_index_rows[sprite_number])
+			break;
 
-		if (!sprite_on_scanline(scanline, y, rows))
-			continue;
+		UINT32 bands = sprite_bands(y, rows);
+		UINT32 changed = bands ^ state->sprite_index_bands[sprite_number];
 
-		/* sprite is on this scanline, add it to active list */
-		*sprite_list = sprite_number;
-		sprite_list++;
+		for (INT32 band = 0; changed != 0; band++, changed >>= 1)
+			if (changed & 0x01)
+				state->sprite_index_band_list[band * SPRITE_INDEX_WORDS + (sprite_number >> 5)] ^= 1 << (sprite_number & 0x1f);
 
-		/* increment sprite count, and if we reached the max, bail out */
-		active_sprite_count++;
+		state->sprite_index_y[sprite_number] = y;
+		state->sprite_index_rows[sprite_number] = rows;
+		state->sprite_index_bands[sprite_number] = bands;
+	}
 
-		if (active_sprite_count == MAX_SPRITES_PER_LINE)
-			break;
+	state->sprite_index_dirty_min = 0xffff;
+	state->sprite_index_dirty_max = 0;
+}
+
+
+static STATE_POSTLOAD( sprite_index_postload )
+{
+	mark_sprite_index_dirty(machine, 0, MAX_SPRITES_PER_SCREEN - 1);
+}
+
+
+static void create_sprite_index( running_machine *machine )
+{
+	neogeo_state *state = machine->driver_data<neogeo_state>();
+
+	state->sprite_index_y = auto_alloc_array_clear(machine, INT16, MAX_SPRITES_PER_SCREEN);
+	state->sprite_index_rows = auto_alloc_array_clear(machine, UINT8, MAX_SPRITES_PER_SCREEN);
+	state->sprite_index_bands = auto_alloc_array_clear(machine, UINT32, MAX_SPRITES_PER_SCREEN);
+	state->sprite_index_band_list = auto_alloc_array_clear(machine, UINT32, SPRITE_INDEX_BANDS * SPRITE_INDEX_WORDS);
+
+	state->sprite_index_dirty_min = 0xffff;
+	state->sprite_index_dirty_max = 0;
+	mark_sprite_index_dirty(machine, 0, MAX_SPRITES_PER_SCREEN - 1);
+
+	state_save_register_postload(machine, sprite_index_postload, NULL);
+}
+
+
+static void parse_sprites( running_machine *machine, int scanline )
+{
+	neogeo_state *state = machine->driver_data<neogeo_state>();
+
+	/* build the list in the copy kept for drawing */
+	UINT16 *line_list = &state->sprite_line_lists[scanline * (MAX_SPRITES_PER_LINE + 1)];
+	UINT16 *sprite_list = line_list;
+	UINT16 *active_list = (scanline & 0x01) ? &state->videoram[0x8680] : &state->videoram[0x8600];
+	UINT32 active_sprite_count = 0;
+	const UINT32 *band_list = &state->sprite_index_band_list[(scanline >> 4) * SPRITE_INDEX_WORDS];
+
+	update_sprite_index(machine);
+
+	/* scan the sprites touching this band, in sprite order */
+	for (INT32 word = 0; word < SPRITE_INDEX_WORDS; word++)
+	{
+		for (UINT32 bits = band_list[word]; bits != 0; bits &= bits - 1)
+		{
+			UINT16 sprite_number = (word << 5) | (31 - count_leading_zeros(bits & -bits));
+
+			if (!sprite_on_scanline(scanline, state->sprite_index_y[sprite_number], state->sprite_index_rows[sprite_number]))
+				continue;
+
+			/* sprite is on this scanline, add it to active list */
+			*sprite_list = sprite_number;
+			sprite_list++;
+
+			/* increment sprite count, and if we reached the max, bail out */
+			active_sprite_count++;
+
+			if (active_sprite_count == MAX_SPRITES_PER_LINE)
+				goto done;
+		}
 	}
+
+done:
 	/* fill the rest of the sprite list with 0, including one extra entry */
 	memset(sprite_list, 0, sizeof(sprite_list[0]) * (MAX_SPRITES_PER_LINE - active_sprite_count + 1));
+
+	/* the active list in video RAM is overwritten two lines later; only store it,
+       and mark video RAM dirty for rewind, when the contents actually change */
+	if (memcmp(active_list, line_list, sizeof(line_list[0]) * (MAX_SPRITES_PER_LINE + 1)) != 0)
+	{
+		memcpy(active_list, line_list, sizeof(line_list[0]) * (MAX_SPRITES_PER_LINE + 1));
+		*state->videoram_dirty = TRUE;
+	}
 }
 
 
-static TIMER_CALLBACK( sprite_line_timer_callback )
+/*************************************
+ *
+ *  Raster synchronization
+ *
+ *  The hardware parses the sprite list of a line at its start and
+ *  draws it during the next one.  Rather than running a timer and a
+ *  one line partial update on every scanline, the sprite lists are
+ *  parsed and the screen drawn up to the beam position only when
+ *  something that affects the picture is about to change, and by
+ *  VIDEO_UPDATE itself.  Runs of untouched lines are then drawn by a
+ *  single multi-line update.
+ *
+ *************************************/
+
+static void parse_sprites_until( running_machine *machine, int scanline )
+{
+	neogeo_state *state = machine->driver_data<neogeo_state>();
+
+	for ( ; state->sprite_line_next <= scanline; state->sprite_line_next++)
+		parse_sprites(machine, state->sprite_line_next);
+}
+
+
+static void video_sync( running_machine *machine )
 {
 	neogeo_state *state = machine->driver_data<neogeo_state>();
+	attotime now = timer_get_time(machine);
+
+	/* nothing to do until the beam reaches the next line */
+	if (attotime_compare(now, state->video_sync_time) < 0)
+		return;
 
-	int scanline = param;
+	int scanline = machine->primary_screen->vpos();
+
+	/* parse the lines started so far and draw the ones completed */
+	parse_sprites_until(machine, scanline);
 
-	/* we are at the beginning of a scanline -
-	   we need to draw the previous scanline and parse the sprites on the current one */
 	if (scanline != 0)
 		machine->primary_screen->update_partial(scanline - 1);
 
-	parse_sprites(machine, scanline);
+	state->video_sync_time = attotime_add(now, machine->primary_screen->time_until_pos((scanline + 1) % NEOGEO_VTOTAL));
+}
+
+
+static TIMER_CALLBACK( sprite_line_timer_callback )
+{
+	neogeo_state *state = machine->driver_data<neogeo_state>();
+
+	/* finish the previous frame, then start over with the first line */
+	parse_sprites_until(machine, NEOGEO_VTOTAL - 1);
+
+	state->sprite_line_next = 0;
+	state->video_sync_time = attotime_zero;
+	video_sync(machine);
+
+	timer_adjust_oneshot(state->sprite_line_timer, machine->primary_screen->time_until_pos(0), 0);
+}
+
 
-	/* let's come back at the beginning of the next line */
-	scanline = (scanline + 1) % NEOGEO_VTOTAL;		// 264
+static STATE_POSTLOAD( video_sync_postload )
+{
+	neogeo_state *state = machine->driver_data<neogeo_state>();
 
-	timer_adjust_oneshot(state->sprite_line_timer, machine->primary_screen->time_until_pos(scanline), scanline);
+	/* states are taken at frame boundaries, with every visible line drawn */
+	state->sprite_line_next = machine->primary_screen->vpos() + 1;
+	state->video_sync_time = attotime_add(timer_get_time(machine), machine->primary_screen->time_until_pos(state->sprite_line_next % NEOGEO_VTOTAL));
 }
 
 
@@ -583,12 +803,18 @@ static void create_sprite_line_timer( running_machine *machine )
 {
 	neogeo_state *state = machine->driver_data<neogeo_state>();
 	state->sprite_line_timer = timer_alloc(machine, sprite_line_timer_callback, NULL);
+	state->sprite_line_lists = auto_alloc_array_clear(machine, UINT16, NEOGEO_VTOTAL * (MAX_SPRITES_PER_LINE + 1));
+
+	state_save_register_postload(machine, video_sync_postload, NULL);
 }
 
 
 static void start_sprite_line_timer( running_machine *machine )
 {
 	neogeo_state *state = machine->driver_data<neogeo_state>();
+
+	state->sprite_line_next = NEOGEO_VTOTAL;
+	state->video_sync_time = attotime_never;
 	timer_adjust_oneshot(state->sprite_line_timer, machine->primary_screen->time_until_pos(0), 0);
 }
 
@@ -597,49 +823,65 @@ static void optimize_sprite_data( running_machine *machine )
 {
 	neogeo_state *state = machine->driver_data<neogeo_state>();
 
-	/* convert the sprite graphics data into a format that allows faster blitting */
-	UINT8 *src;
-	UINT8 *dest;
+	/* convert the sprite graphics data into a format that allows faster blitting:
+	   16 pixels per line, two pixels per byte with the leftmost in the low nibble.
+	   This takes exactly as much space as the ROM data, so convert in place */
+	UINT8 *src = memory_region(machine, "sprites");
+	UINT32 len = memory_region_length(machine, "sprites");
+	UINT8 tile[0x80];
 
 	/* get mask based on the length rounded up to the nearest power of 2 */
 	state->sprite_gfx_address_mask = 0xffffffff;
 
-	UINT32 len = memory_region_length(machine, "sprites");
-
 	for (UINT32 bit = 0x80000000; bit != 0; bit >>= 1)
 	{
-		if (((len * 2) - 1) & bit)
+		if ((len - 1) & bit)
 			break;
 
 		state->sprite_gfx_address_mask >>= 1;
 	}
 
-	state->sprite_gfx = auto_alloc_array_clear(machine, UINT8, state->sprite_gfx_address_mask + 1);
+	state->sprite_gfx = src;
+	state->sprite_gfx_length = len & ~0x7f;
 
-	src = memory_region(machine, "sprites");
-	dest = state->sprite_gfx;
+	if (region_cache_load_region(machine, "sprites", "packed"))
+		return;
 
-	for (UINT32 i = 0; i < len; i += 0x80, src += 0x80)
+	for (UINT32 i = 0; i < state->sprite_gfx_length; i += 0x80, src += 0x80)
 	{
+		UINT8 *dest = tile;
+
 		for (UINT32 y = 0; y < 0x10; y++)
 		{
-			for (UINT32 x = 0; x < 8; x++)
+			for (UINT32 x = 0; x < 8; x += 2)
 			{
 				*(dest++) = (((src[0x43 | (y << 2)] >> x) & 0x01) << 3) |
 						    (((src[0x41 | (y << 2)] >> x) & 0x01) << 2) |
 							(((src[0x42 | (y << 2)] >> x) & 0x01) << 1) |
-							(((src[0x40 | (y << 2)] >> x) & 0x01) << 0);
+							(((src[0x40 | (y << 2)] >> x) & 0x01) << 0) |
+							(((src[0x43 | (y << 2)] >> x) & 0x02) << 6) |
+						    (((src[0x41 | (y << 2)] >> x) & 0x02) << 5) |
+							(((src[0x42 | (y << 2)] >> x) & 0x02) << 4) |
+							(((src[0x40 | (y << 2)] >> x) & 0x02) << 3);
 			}
 
-			for (UINT32 x = 0; x < 8; x++)
+			for (UINT32 x = 0; x < 8; x += 2)
 			{
 				*(dest++) = (((src[0x03 | (y << 2)] >> x) & 0x01) << 3) |
 						    (((src[0x01 | (y << 2)] >> x) & 0x01) << 2) |
 							(((src[0x02 | (y << 2)] >> x) & 0x01) << 1) |
-							(((src[0x00 | (y << 2)] >> x) & 0x01) << 0);
+							(((src[0x00 | (y << 2)] >> x) & 0x01) << 0) |
+							(((src[0x03 | (y << 2)] >> x) & 0x02) << 6) |
+						    (((src[0x01 | (y << 2)] >> x) & 0x02) << 5) |
+							(((src[0x02 | (y << 2)] >> x) & 0x02) << 4) |
+							(((src[0x00 | (y << 2)] >> x) & 0x02) << 3);
 			}
 		}
+
+		memcpy(src, tile, sizeof(tile));
 	}
+
+	region_cache_save_region(machine, "sprites", "packed");
 }
 
 
@@ -763,6 +1005,7 @@ VIDEO_START( neogeo )
 	compute_rgb_weights(machine);
 	create_sprite_line_timer(machine);
 	create_auto_animation_timer(machine);
+	create_sprite_index(machine);
 	optimize_sprite_data(machine);
 
 	/* initialize values that are not modified on a reset */
@@ -791,6 +1034,9 @@ VIDEO_START( neogeo )
 
 	state_save_register_postload(machine, regenerate_pens, NULL);
 
+	/* sprite RAM is large and mostly static; let rewind skip it while untouched */
+	state->videoram_dirty = state_save_track_dirty(machine, state->videoram);
+
 	state->region_zoomy = memory_region(machine, "zoomy");
 }
 
@@ -805,7 +1051,6 @@ VIDEO_RESET( neogeo )
 {
 	start_sprite_line_timer(machine);
 	start_auto_animation_timer(machine);
-	optimize_sprite_data(machine);
 }
 
 /*************************************
@@ -821,9 +1066,15 @@ VIDEO_UPDATE( neogeo )
 	/* fill with background color first */
 	bitmap_fill(bitmap, cliprect, state->pens[0x0fff]);
 
-	draw_sprites(screen->machine, bitmap, cliprect->min_y);
+	/* video state has not changed since the start of any of these lines */
+	parse_sprites_until(screen->machine, cliprect->max_y);
 
-	draw_fixed_layer(screen->machine, bitmap, cliprect->min_y);
+	for (int scanline = cliprect->min_y; scanline <= cliprect->max_y; scanline++)
+	{
+		draw_sprites(screen->machine, bitmap, scanline);
+
+		draw_fixed_layer(screen->machine, bitmap, scanline);
+	}
 
 	return 0;
 }
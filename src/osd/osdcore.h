@@ -49,6 +49,7 @@
 #define __OSDCORE_H__
 
 #include "osdcomm.h"
+#include <time.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -211,6 +212,35 @@ file_error osd_write(osd_file *file, const void *buffer, UINT64 offset, UINT32 l
 file_error osd_rmfile(const char *filename);
 
 
+/*-----------------------------------------------------------------------------
+    osd_map_file: map a whole file read-only into memory
+
+    Parameters:
+
+        filename - path to the file to map
+
+        length - pointer to a UINT64 to receive the length of the file
+
+    Return value:
+
+        a pointer to the contents of the file, or NULL if it could not be
+        mapped; the mapping stays valid until osd_unmap_file is called
+-----------------------------------------------------------------------------*/
+const void *osd_map_file(const char *filename, UINT64 *length);
+
+
+/*-----------------------------------------------------------------------------
+    osd_unmap_file: release a mapping made by osd_map_file
+
+    Parameters:
+
+        base - pointer returned by osd_map_file
+
+        length - length of the file, as returned by osd_map_file
+-----------------------------------------------------------------------------*/
+void osd_unmap_file(const void *base, UINT64 length);
+
+
 /*-----------------------------------------------------------------------------
     osd_get_physical_drive_geometry: if the given path points to a physical
         drive, return the geometry of that drive
@@ -287,6 +317,7 @@ struct _osd_directory_entry
 	const char *		name;			/* name of the entry */
 	osd_dir_entry_type	type;			/* type of the entry */
 	UINT64				size;			/* size of the entry */
+	time_t				last_modified;	/* time of the last change to the entry, or 0 if unknown */
 };
 
 
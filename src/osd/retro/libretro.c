@@ -8,6 +8,9 @@
 #include "uiinput.h"
 #include "libretro.h"
 #include "options.h"
+#include "retroos.h"
+#include "osinline.h"
+#include "cpu/m68000/m68000.h"
 
 
 /*************************************************************************/
@@ -183,9 +186,15 @@ static const _neogeo_bioses neogeo_bioses[] = {
 
 // extern variables
 bool verify_rom_hash = false;
+bool verify_rom_hash_full = false;
 bool allow_select_newgame = false;
 bool RETRO_LOOP = true;
 
+// extra command line options from a host such as the benchmark runner, NULL terminated;
+// at most MAX_EXTRA_ARGS of them are passed on
+#define MAX_EXTRA_ARGS	8
+const char **retro_extra_argv = NULL;
+
 // input device
 static input_device *joypad1_device = NULL;	// P1 JOYPAD
 static input_device *joypad2_device = NULL;	// P2 JOYPAD
@@ -196,6 +205,32 @@ static input_device *keyboard_device = NULL;	// Keyboard
 // a single rendering target
 static render_target *our_target = NULL;
 
+// the running machine, for save states
+static running_machine *retro_machine = NULL;
+
+// work queue for banded software rendering
+static osd_work_queue *render_queue = NULL;
+
+// pipelined rendering: one frame rasterizing while the next is emulated
+typedef struct _render_job render_job;
+struct _render_job
+{
+	render_primitive_list *primlist;	// list being drawn
+	void *buffer;						// destination buffer
+	INT32 width, height;				// destination size
+	volatile INT32 locked;				// set once the worker holds the list lock
+	rgb_t *palette;						// copy of the screen palettes the list draws with
+	UINT32 palette_entries;				// number of entries allocated for it
+};
+
+static osd_work_queue *pipeline_queue = NULL;
+static osd_work_item *pipeline_item = NULL;
+static render_job pipeline_job;
+static UINT32 pipeline_index = 0;
+static bool pipeline_ready = false;
+static void *pipeline_frame = NULL;	// the finished frame, while the next one may be in flight
+static INT32 pipeline_frame_width, pipeline_frame_height;
+
 // the state of each key or button
 static UINT8 pad_state[4][KEY_TOTAL];
 static UINT8 retrokbd_state[2][RETROK_LAST];
@@ -216,6 +251,12 @@ static bool mame_stop = false;
 static bool mame_reset = false;
 static bool FirstTimeUpdate;
 static bool tate;
+static bool rewind_active = false;
+static bool rewind_changed = true;
+static bool audio_hidden = false;
+static bool region_cache = false;
+static int gfx_cache = 0;
+static bool idle_skip = false;
 
 static INT32 retro_width = 320;		// Default texwidth
 static INT32 retro_height = 240;	// Default texheight
@@ -229,6 +270,25 @@ static UINT8 turbo_enable, turbo_delay;
 static UINT32 macro_state;
 static UINT32 screenRot = 0;
 static UINT32 sample_rate = 48000;
+static char resampler[16] = "medium";
+static bool sound_worker = false;
+static UINT32 rewind_seconds = 0;
+static UINT32 rewind_budget = 32;	/* MB */
+static INT32 rewind_button = RETRO_DEVICE_ID_JOYPAD_R2;	/* first pad's button, or -1 for Backspace */
+static UINT32 runahead_frames = 0;
+static UINT8 *runahead_state = NULL;
+static bool render_threads = true;
+static bool render_pipeline = false;
+static bool direct_video = true;
+static bool frame_running = false;	// inside retro_run, where the frontend's framebuffer is valid
+static void *frame_buffer = NULL;	// frontend framebuffer holding this frame, if any
+static size_t frame_pitch = 0;
+static bool frame_shown = false;	// the frontend holds the last frame drawn
+static bool dupe_frames = true;
+#define MAX_FRAME_HASHES	(2048)
+static UINT64 frame_hashes[MAX_FRAME_HASHES];	// last drawn frame: the list, then each screen row
+static UINT32 frame_hash_count = 0;
+static palette_client *frame_palclient = NULL;
 static UINT32 adjust_opt[7] = { 0/*Enable/Disable*/, 0/*Limit*/, 0/*GetRefreshRate*/, 0/*Brightness*/, 0/*Contrast*/, 0/*Gamma*/, 0/*Overclock*/ };
 static float arroffset[4] = { 0/*For brightness*/, 0/*For contrast*/, 0/*For gamma*/, 1.0/*For overclock*/ };
 static double refresh_rate = 60.0;
@@ -303,9 +363,11 @@ static int iptdev_get_state(void *device_internal, void *item_internal);
 
 #ifdef M16B
 	UINT16 videoBuffer[512*512];
+	static UINT16 pipelineBuffer[512*512];
 	#define PITCH	(1)
 #else
 	UINT32 videoBuffer[1024*1024];
+	static UINT32 pipelineBuffer[1024*1024];
 	#define PITCH	(1*2)
 #endif
 
@@ -320,10 +382,7 @@ static retro_audio_sample_batch_t audio_batch_cb = NULL;
 static retro_input_poll_t input_poll_cb = NULL;
 
 unsigned int retro_get_region(void) { return RETRO_REGION_NTSC; }
-size_t retro_serialize_size(void) { return 0; }
 size_t retro_get_memory_size(unsigned type) { return 0; }
-bool retro_serialize(void *data, size_t size) { return false; }
-bool retro_unserialize(const void *data, size_t size) { return false; }
 bool retro_load_game_special(unsigned game_type, const struct retro_game_info *info, size_t num_info) { return false; }
 void *retro_get_memory_data(unsigned type) { return 0; }
 
@@ -338,6 +397,40 @@ void retro_set_input_poll(retro_input_poll_t cb) { input_poll_cb = cb; }
 void retro_set_video_refresh(retro_video_refresh_t cb) { video_cb = cb; }
 
 
+
+size_t retro_serialize_size(void)
+{
+	if (retro_machine == NULL)
+		return 0;
+
+	return state_save_get_buffer_size(retro_machine);
+}
+
+bool retro_serialize(void *data, size_t size)
+{
+	if (retro_machine == NULL)
+		return false;
+
+	/* anonymous timers can't be saved; they are normally flushed by the frame boundary */
+	if (timer_count_anonymous(retro_machine) > 0)
+		return false;
+
+	return state_save_write_buffer(retro_machine, data, size) == STATERR_NONE;
+}
+
+bool retro_unserialize(const void *data, size_t size)
+{
+	if (retro_machine == NULL)
+		return false;
+
+	/* pending anonymous timers could overwrite the data we load */
+	if (timer_count_anonymous(retro_machine) > 0)
+		return false;
+
+	return state_save_read_buffer(retro_machine, data, size) == STATERR_NONE;
+}
+
+
 static void extract_basename(char *buf, const char *path, size_t size)
 {
 	const char *base = strrchr(path, '/');
@@ -389,7 +482,21 @@ void retro_set_environment(retro_environment_t cb)
 	{ "mba_mini_macro_button", 	"Use macro button; disabled|assign A+B to L|assign A+B to R|assign C+D to L|assign C+D to R|assign A+B to L & C+D to R|assign A+B to R & C+D to L" },
 	{ "mba_mini_tate_mode", 	"T.A.T.E mode(Restart); disabled|enabled" },
 	{ "mba_mini_sample_rate", 	"Set sample rate (Restart); 48000Hz|44100Hz|32000Hz|22050Hz" },
-	{ "mba_mini_rom_hash",		"Forced off ROM CRC verfiy(Restart); No|Yes" },
+	{ "mba_mini_resampler",		"Audio resampler quality(Restart); medium|high|fast" },
+	{ "mba_mini_sound_worker",	"Sound chips on a separate thread(Restart); disabled|enabled" },
+	{ "mba_mini_rom_hash",		"ROM CRC verify(Restart); quick|full|disabled" },
+	{ "mba_mini_rewind",		"Rewind while the rewind button is held; disabled|10 seconds|20 seconds|30 seconds|60 seconds" },
+	{ "mba_mini_rewind_button",	"Rewind button (replaces its usual function); R2|L2|L3|R3|Backspace key" },
+	{ "mba_mini_rewind_budget",	"Rewind memory budget; 32MB|16MB|64MB|128MB" },
+	{ "mba_mini_run_ahead",		"Run-ahead to reduce input lag; disabled|1 frame|2 frames|3 frames|4 frames" },
+	{ "mba_mini_render_threads",	"Multithreaded rendering; enabled|disabled" },
+	{ "mba_mini_render_pipeline",	"Render on a separate thread (1 frame latency); disabled|enabled" },
+	{ "mba_mini_direct_video",	"Draw unscaled screens directly; enabled|disabled" },
+	{ "mba_mini_dupe_frames",	"Skip drawing unchanged frames; enabled|disabled" },
+	{ "mba_mini_m68k_block_cache",	"68000 block cache; enabled|disabled" },
+	{ "mba_mini_idle_skip",		"Skip CPU idle loops(Restart); disabled|enabled" },
+	{ "mba_mini_region_cache",	"Cache decrypted ROM data, needs ROM CRC verify(Restart); disabled|enabled" },
+	{ "mba_mini_gfx_cache",		"Limit decoded graphics memory(Restart); disabled|16MB|32MB|64MB|128MB" },
 	{ "mba_mini_neogeo_bios",
 #if defined(USE_FULLY)
 	  "Set NEOGEO BIOS(Restart); Default|Europe MVS(Ver. 2)|Europe MVS(Ver. 1)|USA MVS(Ver. 2?)|USA MVS(Ver. 1)|Asia MVS(Ver. 3)|Asia MVS(Latest)|Japan MVS(Ver. 3)|Japan MVS(Ver. 2)|Japan MVS(Ver. 1)|Japan MVS(J3)|Custom Japanese Hotel|UniBIOS(Ver. 3.2)|UniBIOS(Ver. 3.1)|UniBIOS(Ver. 3.0)|UniBIOS(Ver. 2.3)|UniBIOS(Ver. 2.3 older?)|UniBIOS(Ver. 2.2)|UniBIOS(Ver. 2.1)|UniBIOS(Ver. 2.0)|UniBIOS(Ver. 1.3)|UniBIOS(Ver. 1.2)|UniBIOS(Ver. 1.2 older)|UniBIOS(Ver. 1.1)|UniBIOS(Ver. 1.0)|Debug MVS|Asia AES|Japan AES" },
@@ -510,6 +617,11 @@ static void check_variables(void)
 	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
 		sample_rate = atoi(var.value);
 
+	var.key = "mba_mini_resampler";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+		snprintf(resampler, sizeof(resampler), "%s", var.value);
+
 	var.key = "mba_mini_adj_brightness";
 	var.value = NULL;
 	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
@@ -593,12 +705,150 @@ static void check_variables(void)
 	var.value = NULL;
 	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
 	{
-		if (!strcmp(var.value, "No"))
-			verify_rom_hash = true;
+		// quick trusts the CRCs in the ZIP directory; "Yes" is the old value for disabled
+		verify_rom_hash = strcmp(var.value, "disabled") && strcmp(var.value, "Yes");
+		verify_rom_hash_full = !strcmp(var.value, "full");
+	}
+
+	var.key = "mba_mini_rewind";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		UINT32 temp_value = rewind_seconds;
+		if (!strcmp(var.value, "disabled"))
+			rewind_seconds = 0;
 		else
-			verify_rom_hash = false;
+			rewind_seconds = atoi(var.value);
+
+		if (temp_value != rewind_seconds)
+			rewind_changed = true;
 	}
 
+	var.key = "mba_mini_rewind_button";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "L2"))
+			rewind_button = RETRO_DEVICE_ID_JOYPAD_L2;
+		else if (!strcmp(var.value, "L3"))
+			rewind_button = RETRO_DEVICE_ID_JOYPAD_L3;
+		else if (!strcmp(var.value, "R3"))
+			rewind_button = RETRO_DEVICE_ID_JOYPAD_R3;
+		else if (!strcmp(var.value, "Backspace key"))
+			rewind_button = -1;
+		else
+			rewind_button = RETRO_DEVICE_ID_JOYPAD_R2;
+	}
+
+	var.key = "mba_mini_rewind_budget";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		UINT32 temp_value = rewind_budget;
+		rewind_budget = atoi(var.value);
+
+		if (temp_value != rewind_budget)
+			rewind_changed = true;
+	}
+
+	var.key = "mba_mini_run_ahead";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "disabled"))
+			runahead_frames = 0;
+		else
+			runahead_frames = atoi(var.value);
+	}
+
+	var.key = "mba_mini_render_threads";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "enabled"))
+			render_threads = true;
+		if (!strcmp(var.value, "disabled"))
+			render_threads = false;
+	}
+
+	var.key = "mba_mini_direct_video";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "enabled"))
+			direct_video = true;
+		if (!strcmp(var.value, "disabled"))
+			direct_video = false;
+	}
+
+	var.key = "mba_mini_dupe_frames";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "enabled"))
+			dupe_frames = true;
+		if (!strcmp(var.value, "disabled"))
+			dupe_frames = false;
+		frame_hash_count = 0;
+	}
+
+	var.key = "mba_mini_m68k_block_cache";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "enabled"))
+			m68k_set_block_cache_enable(TRUE);
+		if (!strcmp(var.value, "disabled"))
+			m68k_set_block_cache_enable(FALSE);
+	}
+
+	var.key = "mba_mini_sound_worker";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "enabled"))
+			sound_worker = true;
+		if (!strcmp(var.value, "disabled"))
+			sound_worker = false;
+	}
+
+	var.key = "mba_mini_idle_skip";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "enabled"))
+			idle_skip = true;
+		if (!strcmp(var.value, "disabled"))
+			idle_skip = false;
+	}
+
+	var.key = "mba_mini_region_cache";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "enabled"))
+			region_cache = true;
+		if (!strcmp(var.value, "disabled"))
+			region_cache = false;
+	}
+
+	var.key = "mba_mini_gfx_cache";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+		gfx_cache = atoi(var.value);	// megabytes; 0 for disabled
+
+#if !defined(HAVE_OPENGL) && !defined(HAVE_OPENGLES)
+	var.key = "mba_mini_render_pipeline";
+	var.value = NULL;
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+	{
+		if (!strcmp(var.value, "enabled"))
+			render_pipeline = true;
+		if (!strcmp(var.value, "disabled"))
+			render_pipeline = false;
+	}
+#endif
+
 	if (tmp_ar != set_par)
 		update_geometry();
 }
@@ -706,6 +956,71 @@ void retro_get_system_av_info(struct retro_system_av_info *info)
 #endif
 
 
+/*
+    Run-ahead: emulate the real frame with its audio but no video and
+    snapshot it, emulate the remaining frames silently, render only the
+    last one and then roll back to the snapshot.
+*/
+static void retro_run_ahead(void)
+{
+	UINT32 size = state_save_get_buffer_size(retro_machine);
+	running_machine *machine;
+	UINT8 *snapshot;
+	bool saved;
+
+	if (runahead_state == NULL)
+		runahead_state = auto_alloc_array(retro_machine, UINT8, size);
+
+	video_set_hidden(TRUE);
+	retro_main_loop();
+	RETRO_LOOP = true;
+
+	/* anonymous timers can't be saved; present a duplicate frame instead */
+	saved = (retro_machine != NULL && timer_count_anonymous(retro_machine) == 0 &&
+			state_save_write_buffer(retro_machine, runahead_state, size) == STATERR_NONE);
+	if (!saved)
+	{
+		video_set_hidden(FALSE);
+		return;
+	}
+
+	/* remember what the snapshot belongs to; a teardown clears both */
+	machine = retro_machine;
+	snapshot = runahead_state;
+
+	audio_hidden = true;
+	for (UINT32 i = 1; i < runahead_frames && retro_machine != NULL; i++)
+	{
+		retro_main_loop();
+		RETRO_LOOP = true;
+	}
+
+	video_set_hidden(FALSE);
+	if (retro_machine != NULL)
+	{
+		retro_main_loop();
+		RETRO_LOOP = true;
+	}
+	audio_hidden = false;
+
+	/* the machine may have exited or been reset while running ahead */
+	if (retro_machine != NULL && retro_machine == machine && runahead_state == snapshot)
+		state_save_read_buffer(retro_machine, runahead_state, size);
+}
+
+/* true if rewind is on and has taken over this button of the first pad */
+static bool rewind_owns(unsigned port, INT32 id)
+{
+	return rewind_seconds && port == 0 && rewind_button == id;
+}
+
+static bool rewind_held(void)
+{
+	if (rewind_button < 0)
+		return input_state_cb(0, RETRO_DEVICE_KEYBOARD, 0, RETROK_BACKSPACE) != 0;
+	return input_state_cb(0, RETRO_DEVICE_JOYPAD, 0, rewind_button) != 0;
+}
+
 void retro_run (void)
 {
 	bool updated = false;
@@ -713,18 +1028,78 @@ void retro_run (void)
       		check_variables();
 
 	retro_poll_mame_input();
-	retro_main_loop();
+	frame_running = true;
+
+	if (rewind_changed && retro_machine != NULL)
+	{
+		rewind_changed = false;
+		UINT32 frames = rewind_seconds ? (UINT32)(rewind_seconds * refresh_rate + 0.5) : 0;
+		state_rewind_init(retro_machine, rewind_budget << 20, frames);
+	}
+
+	/* while rewinding, step back one snapshot and replay that frame without recording it */
+	rewind_active = false;
+	if (rewind_seconds && retro_machine != NULL && rewind_held())
+		rewind_active = (timer_count_anonymous(retro_machine) == 0 && state_rewind_pop(retro_machine) == STATERR_NONE);
+
+	if (runahead_frames && !rewind_active && retro_machine != NULL)
+		retro_run_ahead();
+	else
+	{
+		audio_hidden = rewind_active;
+		retro_main_loop();
+	}
+
+	if (rewind_seconds && !rewind_active && retro_machine != NULL && timer_count_anonymous(retro_machine) == 0)
+		state_rewind_push(retro_machine);
 
 	RETRO_LOOP = true;
+	audio_hidden = false;
 
 #if defined(HAVE_OPENGL) || defined(HAVE_OPENGLES)
 	do_gl2d();
+	frame_shown = true;
 #else
-	if (draw_this_frame)
+	if (pipeline_queue != NULL)
+	{
+		/* present the frame the worker finished during this run */
+		if (pipeline_ready)
+		{
+			video_cb(pipeline_frame, pipeline_frame_width, pipeline_frame_height, pipeline_frame_width << PITCH);
+			frame_shown = true;
+		}
+		else
+			video_cb(	NULL, retro_width, retro_height, retro_topwidth << PITCH);
+		pipeline_ready = false;
+	}
+	else if (draw_this_frame && frame_buffer != NULL)
+	{
+		video_cb(frame_buffer, retro_width, retro_height, frame_pitch);
+		frame_shown = true;
+	}
+	else if (draw_this_frame)
+	{
 		video_cb(videoBuffer, retro_width, retro_height, retro_topwidth << PITCH);
+		frame_shown = true;
+	}
 	else
 		video_cb(	NULL, retro_width, retro_height, retro_topwidth << PITCH);
+
+	/* the frontend's buffer is only ours until we return */
+	frame_buffer = NULL;
 #endif
+	frame_running = false;
+}
+
+running_machine *retro_get_machine(void)
+{
+	return retro_machine;
+}
+
+const char *retro_span_benchmark(int kernel, osd_ticks_t *scalar, osd_ticks_t *vector, int *exact)
+{
+	/* one 320x224 frame's worth of pixels */
+	return span_benchmark(kernel, 320 * 224, scalar, vector, exact);
 }
 
 void prep_retro_rotation(int rot)
@@ -1045,6 +1420,14 @@ INLINE void retro_poll_mame_input(void)
 	pad_state[0][KEY_TAB] = input_state_cb(0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_L2);	/* For */
 	pad_state[0][KEY_F2]  = input_state_cb(0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_L3);	/* Player1 */
 
+	/* the rewind button gives up its usual function */
+	if (rewind_owns(0, RETRO_DEVICE_ID_JOYPAD_R3))
+		pad_state[0][KEY_F11] = 0;
+	if (rewind_owns(0, RETRO_DEVICE_ID_JOYPAD_L2))
+		pad_state[0][KEY_TAB] = 0;
+	if (rewind_owns(0, RETRO_DEVICE_ID_JOYPAD_L3))
+		pad_state[0][KEY_F2] = 0;
+
 	for (i = 0; i < MAX_JOYPADS; i++)
 	{
 		pad_state[i][KEY_JOYSTICK_U] = input_state_cb(i, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_UP);
@@ -1098,7 +1481,7 @@ INLINE void retro_poll_mame_input(void)
 			}
 			case 3:
 			{
-				if (PLAYER_PRESS(R2))
+				if (PLAYER_PRESS(R2) && !rewind_owns(i, RETRO_DEVICE_ID_JOYPAD_R2))
 				{
 					if (turbo_state[i][0] > turbo_delay)
 					{
@@ -1112,7 +1495,7 @@ INLINE void retro_poll_mame_input(void)
 			}
 			case 4:
 			{
-				if (PLAYER_PRESS(R2))
+				if (PLAYER_PRESS(R2) && !rewind_owns(i, RETRO_DEVICE_ID_JOYPAD_R2))
 				{
 					if (turbo_state[i][1] > turbo_delay)
 					{
@@ -1150,19 +1533,326 @@ INLINE void retro_poll_mame_input(void)
 
 /**************************************************************************/
 
+//============================================================
+//  retro_draw_primitives
+//============================================================
+
+static void retro_draw_primitives(const render_primitive_list &primlist, void *buffer, INT32 width, INT32 height)
+{
+#ifdef M16B
+	/* a lone unscaled screen converts straight from its bitmap */
+	if (direct_video && rgb565_draw_primitives_direct(primlist, buffer, width, height, width))
+		return;
+
+	if (render_threads && render_queue != NULL)
+		rgb565_draw_primitives_threaded(primlist, buffer, width, height, width, render_queue, osd_num_processors());
+	else
+		rgb565_draw_primitives(primlist, buffer, width, height, width);
+#else
+	if (direct_video && rgb888_draw_primitives_direct(primlist, buffer, width, height, width))
+		return;
+
+	if (render_threads && render_queue != NULL)
+		rgb888_draw_primitives_threaded(primlist, buffer, width, height, width, render_queue, osd_num_processors());
+	else
+		rgb888_draw_primitives(primlist, buffer, width, height, width);
+#endif
+}
+
+//============================================================
+//  retro_draw_frontend
+//============================================================
+
+static bool retro_draw_frontend(const render_primitive_list &primlist)
+{
+#if !defined(HAVE_OPENGL) && !defined(HAVE_OPENGLES)
+	struct retro_framebuffer fb;
+
+	if (!direct_video || !frame_running)
+		return false;
+
+	memset(&fb, 0, sizeof(fb));
+	fb.width = retro_width;
+	fb.height = retro_height;
+	fb.access_flags = RETRO_MEMORY_ACCESS_WRITE;
+	if (!environ_cb(RETRO_ENVIRONMENT_GET_CURRENT_SOFTWARE_FRAMEBUFFER, &fb) || fb.data == NULL)
+		return false;
+	if (fb.width != (unsigned)retro_width || fb.height != (unsigned)retro_height)
+		return false;
+
+	/* only the direct path covers every pixel, so only it can use a buffer with unknown contents */
+#ifdef M16B
+	if (fb.format != RETRO_PIXEL_FORMAT_RGB565 || fb.pitch % sizeof(UINT16) != 0)
+		return false;
+	if (!rgb565_draw_primitives_direct(primlist, fb.data, retro_width, retro_height, fb.pitch / sizeof(UINT16)))
+		return false;
+#else
+	if (fb.format != RETRO_PIXEL_FORMAT_XRGB8888 || fb.pitch % sizeof(UINT32) != 0)
+		return false;
+	if (!rgb888_draw_primitives_direct(primlist, fb.data, retro_width, retro_height, fb.pitch / sizeof(UINT32)))
+		return false;
+#endif
+
+	frame_buffer = fb.data;
+	frame_pitch = fb.pitch;
+	return true;
+#else
+	return false;
+#endif
+}
+
+//============================================================
+//  frame_hash
+//============================================================
+
+INLINE UINT64 frame_hash(UINT64 hash, const void *data, UINT32 bytes)
+{
+	const UINT8 *src = (const UINT8 *)data;
+	UINT64 word;
+
+	for ( ; bytes >= 8; bytes -= 8, src += 8)
+	{
+		memcpy(&word, src, 8);
+		hash = (hash ^ word) * U64(0x9e3779b97f4a7c15);
+		hash ^= hash >> 29;
+	}
+	for ( ; bytes > 0; bytes--)
+		hash = (hash ^ *src++) * U64(0x9e3779b97f4a7c15);
+	return hash;
+}
+
+//============================================================
+//  retro_frame_unchanged
+//============================================================
+
+static bool retro_frame_unchanged(render_primitive_list &primlist)
+{
+	UINT64 listhash = 0;
+	UINT32 count = 1;
+	bool changed = false, overflow = false;
+
+	/* palette writes show up in neither the list nor the bitmaps */
+	if (frame_palclient == NULL && retro_machine->palette != NULL)
+		frame_palclient = palette_client_alloc(retro_machine->palette);
+	if (frame_palclient != NULL && palette_client_get_dirty_list(frame_palclient, NULL, NULL) != NULL)
+		changed = true;
+
+	primlist.acquire_lock();
+	for (const render_primitive *prim = primlist.first(); prim != NULL; prim = prim->next())
+	{
+		/* everything that places and colors the primitive */
+		listhash = frame_hash(listhash, &prim->type, sizeof(prim->type));
+		listhash = frame_hash(listhash, &prim->flags, sizeof(prim->flags));
+		listhash = frame_hash(listhash, &prim->bounds, sizeof(prim->bounds));
+		listhash = frame_hash(listhash, &prim->color, sizeof(prim->color));
+		listhash = frame_hash(listhash, &prim->width, sizeof(prim->width));
+		if (prim->texture.base == NULL)
+			continue;
+		listhash = frame_hash(listhash, &prim->texcoords, sizeof(prim->texcoords));
+		listhash = frame_hash(listhash, &prim->texture.width, sizeof(prim->texture.width));
+		listhash = frame_hash(listhash, &prim->texture.height, sizeof(prim->texture.height));
+		listhash = frame_hash(listhash, &prim->texture.palette, sizeof(prim->texture.palette));
+
+		/* fonts and artwork never change under the same bitmap */
+		if (!PRIMFLAG_GET_SCREENTEX(prim->flags))
+		{
+			listhash = frame_hash(listhash, &prim->texture.base, sizeof(prim->texture.base));
+			continue;
+		}
+
+		/* screens swap between two bitmaps, so compare what they hold, a row at a time */
+		UINT32 format = PRIMFLAG_GET_TEXFORMAT(prim->flags);
+		UINT32 bpp = (format == TEXFORMAT_RGB32 || format == TEXFORMAT_ARGB32) ? 4 : 2;
+		for (UINT32 y = 0; y < prim->texture.height; y++, count++)
+		{
+			if (count == MAX_FRAME_HASHES)
+			{
+				overflow = true;
+				break;
+			}
+
+			UINT64 rowhash = frame_hash(0, (const UINT8 *)prim->texture.base + y * prim->texture.rowpixels * bpp, prim->texture.width * bpp);
+			if (count >= frame_hash_count || frame_hashes[count] != rowhash)
+				changed = true;
+			frame_hashes[count] = rowhash;
+		}
+		if (overflow)
+			break;
+	}
+	primlist.release_lock();
+
+	if (count != frame_hash_count || frame_hashes[0] != listhash)
+		changed = true;
+	frame_hashes[0] = listhash;
+
+	/* a frame too big to remember is never a duplicate, and neither is the next one */
+	frame_hash_count = overflow ? 0 : count;
+	return !changed && !overflow;
+}
+
+//============================================================
+//  render_pipeline_callback
+//============================================================
+
+static void *render_pipeline_callback(void *param, int threadid)
+{
+	render_job *job = (render_job *)param;
+
+	/* hold the list for the whole draw so that the core can't release it under us */
+	job->primlist->acquire_lock();
+	atomic_exchange32(&job->locked, TRUE);
+	retro_draw_primitives(*job->primlist, job->buffer, job->width, job->height);
+	job->primlist->release_lock();
+	return NULL;
+}
+
+//============================================================
+//  render_pipeline_finished
+//============================================================
+
+static void render_pipeline_finished(void)
+{
+	/* remember the frame, since the next job replaces pipeline_job before retro_run presents it */
+	pipeline_frame = pipeline_job.buffer;
+	pipeline_frame_width = pipeline_job.width;
+	pipeline_frame_height = pipeline_job.height;
+	pipeline_ready = true;
+}
+
+//============================================================
+//  render_pipeline_copy_palettes
+//============================================================
+
+static void render_pipeline_copy_palettes(render_primitive_list &primlist)
+{
+	const rgb_t *source = NULL;
+	UINT32 entries, needed = 0, used = 0;
+
+	if (retro_machine == NULL || retro_machine->palette == NULL)
+		return;
+	entries = palette_get_num_colors(retro_machine->palette) * palette_get_num_groups(retro_machine->palette);
+
+	/* palettized screens point at the live machine palette, which the next frame
+       may change while the worker is still drawing this one; give it a copy */
+	primlist.acquire_lock();
+	for (const render_primitive *prim = primlist.first(); prim != NULL; prim = prim->next())
+		if (PRIMFLAG_GET_SCREENTEX(prim->flags) && prim->texture.palette != NULL &&
+			(PRIMFLAG_GET_TEXFORMAT(prim->flags) == TEXFORMAT_PALETTE16 || PRIMFLAG_GET_TEXFORMAT(prim->flags) == TEXFORMAT_PALETTEA16))
+			needed += entries;
+
+	if (needed > pipeline_job.palette_entries)
+	{
+		global_free(pipeline_job.palette);
+		pipeline_job.palette = global_alloc_array(rgb_t, needed);
+		pipeline_job.palette_entries = needed;
+	}
+
+	for (render_primitive *prim = primlist.first(); prim != NULL; prim = prim->next())
+		if (PRIMFLAG_GET_SCREENTEX(prim->flags) && prim->texture.palette != NULL &&
+			(PRIMFLAG_GET_TEXFORMAT(prim->flags) == TEXFORMAT_PALETTE16 || PRIMFLAG_GET_TEXFORMAT(prim->flags) == TEXFORMAT_PALETTEA16))
+		{
+			/* screens sharing a palette share its copy */
+			if (prim->texture.palette != source)
+			{
+				source = prim->texture.palette;
+				memcpy(&pipeline_job.palette[used], source, entries * sizeof(rgb_t));
+				used += entries;
+			}
+			prim->texture.palette = &pipeline_job.palette[used - entries];
+		}
+	primlist.release_lock();
+}
+
+//============================================================
+//  render_pipeline_start
+//============================================================
+
+static void render_pipeline_start(render_primitive_list &primlist)
+{
+	render_pipeline_copy_palettes(primlist);
+
+	/* alternate buffers so that the frontend never sees one being drawn */
+	pipeline_index ^= 1;
+	pipeline_job.primlist = &primlist;
+	pipeline_job.buffer = pipeline_index ? (void *)pipelineBuffer : (void *)videoBuffer;
+	pipeline_job.width = retro_width;
+	pipeline_job.height = retro_height;
+	pipeline_job.locked = FALSE;
+
+	pipeline_item = osd_work_item_queue(pipeline_queue, render_pipeline_callback, &pipeline_job, 0);
+	if (pipeline_item == NULL)
+	{
+		render_pipeline_callback(&pipeline_job, 0);
+		render_pipeline_finished();
+		return;
+	}
+
+	/* don't let emulation resume until the worker owns the list */
+	while (!pipeline_job.locked)
+		osd_yield_processor();
+}
+
+//============================================================
+//  render_pipeline_wait
+//============================================================
+
+static void render_pipeline_wait(void)
+{
+	if (pipeline_item == NULL)
+		return;
+
+	while (!osd_work_item_wait(pipeline_item, osd_ticks_per_second()))
+		;
+	osd_work_item_release(pipeline_item);
+	pipeline_item = NULL;
+	render_pipeline_finished();
+}
+
+//============================================================
+//  render_pipeline_stop
+//============================================================
+
+static void render_pipeline_stop(void)
+{
+	render_pipeline_wait();
+	if (pipeline_queue != NULL)
+		osd_work_queue_free(pipeline_queue);
+	pipeline_queue = NULL;
+
+	global_free(pipeline_job.palette);
+	pipeline_job.palette = NULL;
+	pipeline_job.palette_entries = 0;
+}
+
 void osd_exit(running_machine &machine)
 {
 	LOGI("osd_exit called \n");
 
+	/* the worker may still be drawing from our target's list */
+	render_pipeline_stop();
+
 	machine.render().target_free(our_target);
 
 	our_target = NULL;
+	retro_machine = NULL;
+	runahead_state = NULL;
+	rewind_changed = true;
+
+	if (frame_palclient != NULL)
+		palette_client_free(frame_palclient);
+	frame_palclient = NULL;
+	frame_hash_count = 0;
+	frame_shown = false;
 
 	global_free(keyboard_device);
 	global_free(joypad4_device);
 	global_free(joypad3_device);
 	global_free(joypad2_device);
 	global_free(joypad1_device);
+
+	if (render_queue != NULL)
+		osd_work_queue_free(render_queue);
+	render_queue = NULL;
 }
 
 void osd_init(running_machine *machine)
@@ -1172,6 +1862,12 @@ void osd_init(running_machine *machine)
 	// initialize the video system by allocating a rendering target
 	our_target = machine->render().target_alloc(NULL, 0);
 
+	retro_machine = machine;
+
+	// rendering bands run on every processor, the calling thread included
+	if (osd_num_processors() > 1)
+		render_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI | WORK_QUEUE_FLAG_HIGH_FREQ);
+
 	fprintf(stderr, "SOURCE FILE: %s\n", machine->gamedrv->source_file);
 	fprintf(stderr, "PARENT: %s\n", machine->gamedrv->parent);
 	fprintf(stderr, "NAME: %s\n", machine->gamedrv->name);
@@ -1201,6 +1897,13 @@ void osd_init(running_machine *machine)
 
 void osd_update(running_machine *machine, int skip_redraw)
 {
+	/* collect the frame rasterized while this one was emulated */
+	render_pipeline_wait();
+	if (render_pipeline && pipeline_queue == NULL && osd_num_processors() > 1)
+		pipeline_queue = osd_work_queue_alloc(0);
+	else if (!render_pipeline && pipeline_queue != NULL)
+		render_pipeline_stop();
+
 	if (mame_reset)
 	{
 		mame_reset = false;
@@ -1236,7 +1939,9 @@ void osd_update(running_machine *machine, int skip_redraw)
 
 		if (adjust_opt[0])
 		{
+			/* brightness, contrast and gamma change the lookups under the same palette */
 			adjust_opt[0] = 0;
+			frame_hash_count = 0;
 			if (adjust_opt[1])
 			{
 				if (adjust_opt[2])
@@ -1291,23 +1996,33 @@ void osd_update(running_machine *machine, int skip_redraw)
 			}
 		}
 
-		UINT8 *surfptr = (UINT8 *)videoBuffer;
-
 		/* make that the size of our target */
 		our_target->set_bounds(retro_width, retro_height);
 
 		/* get the list of primitives for the target at the current size */
 		render_primitive_list &primlist = our_target->get_primitives();
 
-		/* lock them, and then render them */
-		primlist.acquire_lock();
-#ifdef M16B
-		rgb565_draw_primitives(primlist, surfptr, retro_width, retro_height, retro_width);
-#else
-		rgb888_draw_primitives(primlist, surfptr, retro_width, retro_height, retro_width);
-#endif
-		/* do the drawing here */
-		primlist.release_lock();
+		/* an identical frame needs neither drawing nor uploading, once the */
+		/* frontend holds the previous one (or is about to, from the worker) */
+		bool unchanged = dupe_frames && retro_frame_unchanged(primlist);
+		if (unchanged && (frame_shown || (pipeline_queue != NULL && pipeline_ready)))
+			draw_this_frame = false;
+
+		/* hand them to the worker, or lock them and render them here */
+		else if (pipeline_queue != NULL)
+		{
+			frame_shown = false;
+			render_pipeline_start(primlist);
+		}
+		else
+		{
+			frame_shown = false;
+			primlist.acquire_lock();
+			frame_buffer = NULL;
+			if (!retro_draw_frontend(primlist))
+				retro_draw_primitives(primlist, videoBuffer, retro_width, retro_height);
+			primlist.release_lock();
+		}
 	}
 	else
 		draw_this_frame = false;
@@ -1338,7 +2053,7 @@ void osd_wait_for_debugger(running_device *device, int firststop)
 //============================================================
 void osd_update_audio_stream(running_machine *machine, short *buffer, int samples_this_frame)
 {
-	if (!mame_stop)
+	if (!mame_stop && !audio_hidden)
 		audio_batch_cb(buffer, samples_this_frame);
 }
 
@@ -1444,6 +2159,8 @@ static int executeGame(char *path)
 
 	const char *sysdir;
 	char retro_system_dir[1024];
+	char retro_cache_dir[1024];
+	char gfx_cache_size[16];
 	unsigned char exist_dir = 0;
 
 	const char *xargv[] = {
@@ -1451,6 +2168,11 @@ static int executeGame(char *path)
 		NULL, NULL, NULL, NULL,
 		NULL, NULL, NULL, NULL,
 		NULL, NULL, NULL, NULL,
+		NULL, NULL, NULL, NULL,
+		NULL, NULL, NULL, NULL,
+		NULL, NULL, NULL, NULL,
+		NULL, NULL, NULL, NULL,
+		NULL, NULL, NULL, NULL,
 		NULL, NULL, NULL, NULL
 	};
 
@@ -1485,10 +2207,13 @@ static int executeGame(char *path)
 	if (environ_cb(RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY, &sysdir) && sysdir)
 	{
 		snprintf(retro_system_dir, sizeof(retro_system_dir), "%s", sysdir);
+		snprintf(retro_cache_dir, sizeof(retro_cache_dir), "%s", sysdir);
 #ifdef _WIN32
 		strcat(retro_system_dir, "\\mba-cheat");
+		strcat(retro_cache_dir, "\\mba-cache");
 #else
 		strcat(retro_system_dir, "/mba-cheat");
+		strcat(retro_cache_dir, "/mba-cache");
 #endif
 		exist_dir = 1;
 		LOGI("CHEAT Files Directory: %s\n", retro_system_dir);
@@ -1510,6 +2235,42 @@ static int executeGame(char *path)
 	xargv[paramCount++] = (char *)"-memcard_directory";
 	xargv[paramCount++] = (char *)retro_content_dir;
 
+	// the cache directory also keeps the hashes of ROMs that had to be read to verify them
+	if (exist_dir)
+	{
+		xargv[paramCount++] = (char *)"-rgncache_directory";
+		xargv[paramCount++] = (char *)retro_cache_dir;
+		if (region_cache)
+			xargv[paramCount++] = (char *)"-region_cache";
+	}
+
+	if (gfx_cache != 0)
+	{
+		snprintf(gfx_cache_size, sizeof(gfx_cache_size), "%d", gfx_cache);
+		xargv[paramCount++] = (char *)"-gfx_cache";
+		xargv[paramCount++] = gfx_cache_size;
+	}
+
+	xargv[paramCount++] = (char *)"-resampler";
+	xargv[paramCount++] = resampler;
+
+	// a worker only pays off with a processor to spare for it
+	if (sound_worker && osd_num_processors() > 1)
+		xargv[paramCount++] = (char *)"-sound_worker";
+
+	if (idle_skip)
+		xargv[paramCount++] = (char *)"-idle_skip";
+
+	// at most 8 extra options, leaving room for rotation, bios and cheat
+	if (retro_extra_argv != NULL)
+	{
+		int i;
+		for (i = 0; i < MAX_EXTRA_ARGS && retro_extra_argv[i] != NULL; i++)
+			xargv[paramCount++] = retro_extra_argv[i];
+		if (retro_extra_argv[i] != NULL)
+			LOGI("only %d extra options are supported, ignoring %s and the rest\n", MAX_EXTRA_ARGS, retro_extra_argv[i]);
+	}
+
 	if (!tate)
 	{
 		switch (screenRot)
@@ -0,0 +1,428 @@
+/***************************************************************************
+
+    retrobench.c
+
+    Headless benchmark runner: drives the libretro core with stub
+    callbacks for a fixed number of frames, optionally replaying an
+    .inp input log, and reports emulation speed and frame times.
+
+    usage: mba_more_bench [options] <path/to/game.zip>
+
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "emu.h"
+#include "sound/qsound.h"
+#include "libretro.h"
+
+
+//============================================================
+//  CONSTANTS
+//============================================================
+
+#define MAX_OVERRIDES		(16)
+#define MAX_VARIABLES		(64)
+#define MAX_BENCH_DEVICES	(16)
+#define MAX_BENCH_RATES		(16)
+
+
+//============================================================
+//  TYPE DEFINITIONS
+//============================================================
+
+typedef struct _bench_variable bench_variable;
+struct _bench_variable
+{
+	const char *	key;					// option key
+	char			value[64];				// current value
+};
+
+typedef struct _bench_device bench_device;
+struct _bench_device
+{
+	device_execute_interface *exec;			// executing device
+	UINT64			start_cycles;			// total cycles when timing began
+	UINT64			start_idle_loops;		// idle loops skipped when timing began
+	UINT64			start_idle_cycles;		// idle cycles skipped when timing began
+};
+
+
+//============================================================
+//  GLOBAL VARIABLES
+//============================================================
+
+extern const char **retro_extra_argv;
+extern running_machine *retro_get_machine(void);
+extern const char *retro_span_benchmark(int kernel, osd_ticks_t *scalar, osd_ticks_t *vector, int *exact);
+
+static bench_variable variables[MAX_VARIABLES];
+static int variable_count;
+
+static const char *overrides[MAX_OVERRIDES];
+static int override_count;
+
+static const char *system_dir = NULL;
+
+
+//============================================================
+//  LIBRETRO CALLBACKS
+//============================================================
+
+static void bench_set_variables(const struct retro_variable *vars)
+{
+	for (variable_count = 0; vars[variable_count].key != NULL && variable_count < MAX_VARIABLES; variable_count++)
+	{
+		bench_variable *var = &variables[variable_count];
+		const char *def = strstr(vars[variable_count].value, "; ");
+		int length;
+
+		// the default is the first value after the description
+		var->key = vars[variable_count].key;
+		def = (def != NULL) ? def + 2 : "";
+		length = strcspn(def, "|");
+		if (length >= (int)sizeof(var->value))
+			length = sizeof(var->value) - 1;
+		memcpy(var->value, def, length);
+		var->value[length] = 0;
+
+		// apply any -opt key=value from the command line
+		for (int i = 0; i < override_count; i++)
+		{
+			const char *equals = strchr(overrides[i], '=');
+			if (equals != NULL && strlen(var->key) == (size_t)(equals - overrides[i]) && !strncmp(overrides[i], var->key, equals - overrides[i]))
+				snprintf(var->value, sizeof(var->value), "%s", equals + 1);
+		}
+	}
+}
+
+static bool bench_environment(unsigned cmd, void *data)
+{
+	switch (cmd)
+	{
+		case RETRO_ENVIRONMENT_SET_PIXEL_FORMAT:
+		case RETRO_ENVIRONMENT_SET_ROTATION:
+		case RETRO_ENVIRONMENT_SET_GEOMETRY:
+		case RETRO_ENVIRONMENT_SET_INPUT_DESCRIPTORS:
+			return true;
+
+		case RETRO_ENVIRONMENT_SET_VARIABLES:
+			bench_set_variables((const struct retro_variable *)data);
+			return true;
+
+		case RETRO_ENVIRONMENT_GET_VARIABLE:
+		{
+			struct retro_variable *var = (struct retro_variable *)data;
+			for (int i = 0; i < variable_count; i++)
+				if (!strcmp(variables[i].key, var->key))
+				{
+					var->value = variables[i].value;
+					return true;
+				}
+			return false;
+		}
+
+		case RETRO_ENVIRONMENT_GET_VARIABLE_UPDATE:
+			*(bool *)data = false;
+			return true;
+
+		case RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY:
+			*(const char **)data = system_dir;
+			return system_dir != NULL;
+	}
+	return false;
+}
+
+static void bench_video_refresh(const void *data, unsigned width, unsigned height, size_t pitch) { }
+static size_t bench_audio_sample_batch(const int16_t *data, size_t frames) { return frames; }
+static void bench_input_poll(void) { }
+static int16_t bench_input_state(unsigned port, unsigned device, unsigned index, unsigned id) { return 0; }
+
+
+//============================================================
+//  STATISTICS
+//============================================================
+
+static int compare_ticks(const void *a, const void *b)
+{
+	osd_ticks_t ta = *(const osd_ticks_t *)a, tb = *(const osd_ticks_t *)b;
+	return (ta < tb) ? -1 : (ta > tb) ? 1 : 0;
+}
+
+static double ticks_to_ms(osd_ticks_t ticks)
+{
+	return (double)ticks * 1000.0 / (double)osd_ticks_per_second();
+}
+
+static void report_resampler(running_machine *machine)
+{
+	static const char *const names[STREAM_RESAMPLE_QUALITIES] = { "fast", "medium", "high" };
+	int rates[MAX_BENCH_RATES];
+	int rate_count = 0;
+
+	// collect the distinct stream rates that get converted to the output rate
+	for (device_t *device = machine->m_devicelist.first(); device != NULL; device = device->next())
+	{
+		sound_stream *stream;
+		for (int index = 0; (stream = stream_find_by_device(device, index)) != NULL; index++)
+		{
+			int rate = stream_get_sample_rate(stream), known = FALSE;
+			for (int i = 0; i < rate_count; i++)
+				known |= (rates[i] == rate);
+			if (!known && rate != machine->sample_rate && rate_count < MAX_BENCH_RATES)
+				rates[rate_count++] = rate;
+		}
+	}
+
+	// cost of converting one second of one channel at each quality
+	for (int i = 0; i < rate_count; i++)
+	{
+		printf("resample %6d -> %d Hz:", rates[i], machine->sample_rate);
+		for (int quality = 0; quality < STREAM_RESAMPLE_QUALITIES; quality++)
+			printf(" %s %.3f ms%s", names[quality], ticks_to_ms(stream_resample_benchmark(machine, quality, rates[i], machine->sample_rate)),
+				(quality < STREAM_RESAMPLE_QUALITIES - 1) ? "," : " per second of audio\n");
+	}
+}
+
+static void report_timers(running_machine *machine)
+{
+	static const int extra[] = { 8, 32, 128 };
+	const int adjustments = 100000;
+
+	// cost of rescheduling one timer with more and more others waiting
+	for (int i = 0; i < ARRAY_LENGTH(extra); i++)
+	{
+		osd_ticks_t ticks = timer_benchmark(machine, extra[i], adjustments);
+		if (ticks != 0)
+			printf("timers +%-3d    %.1f ns per reschedule\n", extra[i], ticks_to_ms(ticks) * 1000000.0 / adjustments);
+	}
+}
+
+static int report_qsound(running_machine *machine)
+{
+	const int updates = 20000;
+	int total = 0;
+
+	// the block renderer against the per-sample one it replaced, over the same register trace
+	for (device_t *device = machine->m_devicelist.first(); device != NULL; device = device->next())
+		if (device->type() == QSOUND)
+		{
+			osd_ticks_t reference, block;
+			int mismatches = qsound_benchmark(device, updates, &reference, &block);
+			printf("qsound %-7s %d updates %s, per-sample %.3f ms, block %.3f ms (%.2fx)\n", device->tag(), updates,
+				(mismatches == 0) ? "bit-exact" : "MISMATCHED", ticks_to_ms(reference), ticks_to_ms(block),
+				(block != 0) ? (double)reference / (double)block : 0.0);
+			if (mismatches != 0)
+				printf("qsound %-7s %d updates differed from the per-sample renderer\n", device->tag(), mismatches);
+			total += mismatches;
+		}
+	return total;
+}
+
+static int report_spans(void)
+{
+	osd_ticks_t scalar, vector;
+	const char *name;
+	int exact, failed = FALSE;
+
+	// each vector span helper against its plain C form, per 320x224 frame
+	for (int kernel = 0; (name = retro_span_benchmark(kernel, &scalar, &vector, &exact)) != NULL; kernel++)
+	{
+		printf("span %-19s C %.3f ms, vector %.3f ms (%.2fx), %s\n", name, ticks_to_ms(scalar), ticks_to_ms(vector),
+			(vector != 0) ? (double)scalar / (double)vector : 0.0, exact ? "bit-exact" : "MISMATCHED");
+		failed |= !exact;
+	}
+	return failed;
+}
+
+static void usage(const char *name)
+{
+	fprintf(stderr,
+		"usage: %s [options] <game.zip>\n"
+		"  -frames <n>       frames to time (default 3000)\n"
+		"  -warmup <n>       frames to run before timing (default 60)\n"
+		"  -playback <file>  replay an .inp input log\n"
+		"  -video            render frames instead of skipping them\n"
+		"  -resampler        report the cost of each resampler quality for the game's rates\n"
+		"  -timers           report the cost of rescheduling a timer with extra timers waiting\n"
+		"  -qsound           check the QSound block renderer against the per-sample one and time both;\n"
+		"                    exits with 1 if they differ\n"
+		"  -spans            check the vector span helpers of the software renderer against\n"
+		"                    their plain C forms and time both; exits with 1 if they differ\n"
+		"  -system <dir>     libretro system directory\n"
+		"  -opt <key=value>  set a core option, e.g. mba_mini_render_threads=disabled\n"
+		"                    (mba_mini_idle_skip=enabled also reports the cycles idle loops saved)\n", name);
+}
+
+
+//============================================================
+//  MAIN
+//============================================================
+
+int main(int argc, char *argv[])
+{
+	static char inp_dir[1024];
+	static const char *extra_argv[8];
+	struct retro_game_info info;
+	bench_device devices[MAX_BENCH_DEVICES];
+	int device_count = 0, extra_count = 0;
+	int frames = 3000, warmup = 60, render = FALSE, resample = FALSE, timers = FALSE, qsound = FALSE, spans = FALSE, failed = FALSE;
+	const char *playback = NULL, *game = NULL;
+	osd_ticks_t *frame_ticks, total_ticks, load_ticks, start;
+	running_machine *machine;
+	attotime emu_start, emu_time;
+	double real_seconds, emu_seconds;
+
+	for (int arg = 1; arg < argc; arg++)
+	{
+		if (!strcmp(argv[arg], "-frames") && arg + 1 < argc)
+			frames = atoi(argv[++arg]);
+		else if (!strcmp(argv[arg], "-warmup") && arg + 1 < argc)
+			warmup = atoi(argv[++arg]);
+		else if (!strcmp(argv[arg], "-playback") && arg + 1 < argc)
+			playback = argv[++arg];
+		else if (!strcmp(argv[arg], "-video"))
+			render = TRUE;
+		else if (!strcmp(argv[arg], "-resampler"))
+			resample = TRUE;
+		else if (!strcmp(argv[arg], "-timers"))
+			timers = TRUE;
+		else if (!strcmp(argv[arg], "-qsound"))
+			qsound = TRUE;
+		else if (!strcmp(argv[arg], "-spans"))
+			spans = TRUE;
+		else if (!strcmp(argv[arg], "-system") && arg + 1 < argc)
+			system_dir = argv[++arg];
+		else if (!strcmp(argv[arg], "-opt") && arg + 1 < argc && override_count < MAX_OVERRIDES)
+			overrides[override_count++] = argv[++arg];
+		else if (argv[arg][0] != '-' && game == NULL)
+			game = argv[arg];
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (game == NULL || frames <= 0 || warmup < 0)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+
+	// never sleep to real time; the log is found through the input directory
+	extra_argv[extra_count++] = "-nothrottle";
+	if (playback != NULL)
+	{
+		const char *slash = strrchr(playback, '/');
+		if (slash != NULL)
+			snprintf(inp_dir, sizeof(inp_dir), "%.*s", (int)(slash - playback), playback);
+		else
+			strcpy(inp_dir, ".");
+		extra_argv[extra_count++] = "-input_directory";
+		extra_argv[extra_count++] = inp_dir;
+		extra_argv[extra_count++] = "-playback";
+		extra_argv[extra_count++] = (slash != NULL) ? slash + 1 : playback;
+	}
+	extra_argv[extra_count] = NULL;
+	retro_extra_argv = extra_argv;
+
+	retro_set_environment(bench_environment);
+	retro_set_video_refresh(bench_video_refresh);
+	retro_set_audio_sample_batch(bench_audio_sample_batch);
+	retro_set_input_poll(bench_input_poll);
+	retro_set_input_state(bench_input_state);
+	retro_init();
+
+	memset(&info, 0, sizeof(info));
+	info.path = game;
+	start = osd_ticks();
+	if (!retro_load_game(&info) || (machine = retro_get_machine()) == NULL)
+	{
+		fprintf(stderr, "Unable to load %s\n", game);
+		return 1;
+	}
+
+	// loading runs up to the first frame, so this covers ROM loading and decryption
+	load_ticks = osd_ticks() - start;
+
+	if (!render)
+		video_set_hidden(TRUE);
+
+	for (int frame = 0; frame < warmup; frame++)
+		retro_run();
+
+	// snapshot the executing devices and the emulated clock
+	device_execute_interface *exec = NULL;
+	for (bool gotone = machine->m_devicelist.first(exec); gotone && device_count < MAX_BENCH_DEVICES; gotone = exec->next(exec))
+	{
+		devices[device_count].exec = exec;
+		devices[device_count].start_idle_loops = exec->idle_loops_skipped();
+		devices[device_count].start_idle_cycles = exec->idle_cycles_skipped();
+		devices[device_count++].start_cycles = exec->total_cycles();
+	}
+	emu_start = timer_get_time(machine);
+
+	frame_ticks = global_alloc_array(osd_ticks_t, frames);
+	total_ticks = 0;
+	for (int frame = 0; frame < frames; frame++)
+	{
+		start = osd_ticks();
+		retro_run();
+		frame_ticks[frame] = osd_ticks() - start;
+		total_ticks += frame_ticks[frame];
+	}
+
+	emu_time = attotime_sub(timer_get_time(machine), emu_start);
+	real_seconds = (double)total_ticks / (double)osd_ticks_per_second();
+	emu_seconds = attotime_to_double(emu_time);
+
+	printf("game:          %s (%s)\n", machine->gamedrv->name, machine->gamedrv->description);
+	printf("frames:        %d (after %d warmup)%s\n", frames, warmup, render ? "" : ", video skipped");
+	printf("playback:      %s\n", (playback != NULL) ? playback : "none");
+	printf("load time:     %.3f s\n", (double)load_ticks / (double)osd_ticks_per_second());
+	printf("real time:     %.3f s\n", real_seconds);
+	printf("emulated time: %.3f s\n", emu_seconds);
+	printf("frame rate:    %.2f fps\n", frames / real_seconds);
+	printf("speed:         %.2f%%\n", emu_seconds * 100.0 / real_seconds);
+
+	// per-device throughput over the timed frames
+	for (int i = 0; i < device_count; i++)
+	{
+		UINT64 cycles = devices[i].exec->total_cycles() - devices[i].start_cycles;
+		printf("%-14s %12" I64FMT "u cycles, %8.3f MHz effective, %8.3f MHz emulated\n",
+			devices[i].exec->device().tag(), cycles, cycles / real_seconds / 1000000.0,
+			emu_seconds > 0 ? cycles / emu_seconds / 1000000.0 : 0.0);
+
+		// cycles the idle loop detector skipped instead of interpreting
+		if (devices[i].exec->idle_detection())
+		{
+			UINT64 idle = devices[i].exec->idle_cycles_skipped() - devices[i].start_idle_cycles;
+			printf("%-14s %12" I64FMT "u cycles skipped in %" I64FMT "u idle loops, %.2f%%\n", "",
+				idle, devices[i].exec->idle_loops_skipped() - devices[i].start_idle_loops, cycles ? idle * 100.0 / cycles : 0.0);
+		}
+	}
+
+	// frame time distribution
+	qsort(frame_ticks, frames, sizeof(frame_ticks[0]), compare_ticks);
+	printf("frame time:    p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+		ticks_to_ms(frame_ticks[frames * 50 / 100]),
+		ticks_to_ms(frame_ticks[frames * 90 / 100]),
+		ticks_to_ms(frame_ticks[frames * 99 / 100]),
+		ticks_to_ms(frame_ticks[frames - 1]));
+	global_free(frame_ticks);
+
+	if (resample)
+		report_resampler(machine);
+	if (timers)
+		report_timers(machine);
+	if (qsound)
+		failed |= (report_qsound(machine) != 0);
+	if (spans)
+		failed |= report_spans();
+
+	retro_unload_game();
+	retro_deinit();
+	return failed ? 1 : 0;
+}
@@ -118,6 +118,14 @@ static UINT64 osd_get_file_size(const char *file)
 	return st.st_size;
 }
 
+static time_t osd_get_file_time(const char *file)
+{
+	sdl_stat st;
+	if (sdl_stat_fn(file, &st))
+		return 0;
+	return st.st_mtime;
+}
+
 //============================================================
 //  osd_opendir
 //============================================================
@@ -205,6 +213,7 @@ const osd_directory_entry *osd_readdir(osd_directory *dir)
 	dir->ent.type = get_attributes_stat(temp);
 #endif
 	dir->ent.size = osd_get_file_size(temp);
+	dir->ent.last_modified = osd_get_file_time(temp);
 	osd_free(temp);
 
 	return &dir->ent;
@@ -13,6 +13,9 @@
 #endif
 
 #include <sys/stat.h>
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdio.h>
@@ -390,6 +393,61 @@ file_error osd_rmfile(const char *filename)
 	return FILERR_NONE;
 }
 
+//============================================================
+//  osd_map_file
+//============================================================
+
+const void *osd_map_file(const char *filename, UINT64 *length)
+{
+	struct stat st;
+	void *base;
+#if defined(WIN32)
+	int fd = open(filename, O_RDONLY | O_BINARY);
+#else
+	int fd = open(filename, O_RDONLY);
+#endif
+
+	if (fd == -1)
+		return NULL;
+
+	if (fstat(fd, &st) == -1 || st.st_size == 0)
+	{
+		close(fd);
+		return NULL;
+	}
+
+#if defined(WIN32)
+	// no mapping here; read the whole file instead
+	base = osd_malloc(st.st_size);
+	if (base != NULL && read(fd, base, st.st_size) != st.st_size)
+	{
+		osd_free(base);
+		base = NULL;
+	}
+#else
+	base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (base == MAP_FAILED)
+		base = NULL;
+#endif
+	close(fd);
+
+	*length = st.st_size;
+	return base;
+}
+
+//============================================================
+//  osd_unmap_file
+//============================================================
+
+void osd_unmap_file(const void *base, UINT64 length)
+{
+#if defined(WIN32)
+	osd_free((void *)base);
+#else
+	munmap((void *)base, length);
+#endif
+}
+
 //============================================================
 //  create_path_recursive
 //============================================================